@@ -0,0 +1,125 @@
+#include "BoxFilter.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+
+// Output rows [y0, y1). `padded` is bordered so output (y, x) covers padded rows
+// y..y+ky-1 and columns x..x+kx-1; channels stay interleaved.
+template <typename T, typename Acc>
+void boxBand(const cv::Mat& padded, cv::Mat& dst, int kx, int ky, int y0, int y1)
+{
+    const int cn = dst.channels();
+    const int rowLen = padded.cols * cn;
+    const int outLen = dst.cols * cn;
+    const int span = (kx - 1) * cn;
+    const double scale = 1.0 / ((double)kx * ky);
+
+    std::vector<Acc> colSum(rowLen, 0);
+    for (int py = y0; py < y0 + ky; py++)
+    {
+        const T* row = padded.ptr<T>(py);
+        for (int i = 0; i < rowLen; i++) colSum[i] += row[i];
+    }
+
+    for (int y = y0; y < y1; y++)
+    {
+        if (y > y0)
+        {
+            const T* in = padded.ptr<T>(y + ky - 1);
+            const T* gone = padded.ptr<T>(y - 1);
+            for (int i = 0; i < rowLen; i++) colSum[i] += (Acc)in[i] - (Acc)gone[i];
+        }
+
+        T* out = dst.ptr<T>(y);
+        for (int ch = 0; ch < cn; ch++)
+        {
+            Acc s = 0;
+            for (int i = ch; i <= ch + span; i += cn) s += colSum[i];
+            out[ch] = cv::saturate_cast<T>(s * scale);
+            for (int i = ch + cn; i < outLen; i += cn)
+            {
+                s += colSum[i + span] - colSum[i - cn];
+                out[i] = cv::saturate_cast<T>(s * scale);
+            }
+        }
+    }
+}
+
+typedef void (*BandFn)(const cv::Mat&, cv::Mat&, int, int, int, int);
+
+BandFn bandFor(int depth, bool wide)
+{
+    switch (depth)
+    {
+        case CV_8U:  return wide ? boxBand<uchar, int64_t>    : boxBand<uchar, int32_t>;
+        case CV_16U: return wide ? boxBand<uint16_t, int64_t> : boxBand<uint16_t, int32_t>;
+        case CV_16S: return wide ? boxBand<int16_t, int64_t>  : boxBand<int16_t, int32_t>;
+        case CV_32F: return boxBand<float, double>;
+        case CV_64F: return boxBand<double, double>;
+        default:     return nullptr;
+    }
+}
+
+} // namespace
+
+cv::Mat BoxFilter::apply(const cv::Mat& input, int kernelWidth, int kernelHeight)
+{
+    if (input.empty()) return cv::Mat();
+    if (kernelHeight <= 0) kernelHeight = kernelWidth;
+    CV_Assert(kernelWidth >= 1 && kernelHeight >= 1);
+
+    const int depth = input.depth();
+    double maxAbs = (depth == CV_8U) ? 255.0 : (depth == CV_16U) ? 65535.0 : 32768.0;
+    bool wide = (double)kernelWidth * kernelHeight * maxAbs > (double)INT_MAX;
+    BandFn band = bandFor(depth, wide);
+    CV_Assert(band != nullptr);
+
+    int left = kernelWidth / 2, top = kernelHeight / 2;
+    cv::Mat padded, output(input.size(), input.type());
+    cv::copyMakeBorder(input, padded, top, kernelHeight - 1 - top, left, kernelWidth - 1 - left,
+                       cv::BORDER_REFLECT_101);
+
+    // Bands at least one window tall keep the per-band column-sum set-up amortised
+    const int minBandRows = std::max(32, kernelHeight);
+    const int bands = std::max(1, std::min(input.rows / minBandRows, cv::getNumThreads() * 4));
+    cv::parallel_for_(cv::Range(0, bands), [&](const cv::Range& range) {
+        for (int b = range.start; b < range.end; b++)
+        {
+            int y0 = (int)((int64)input.rows * b / bands);
+            int y1 = (int)((int64)input.rows * (b + 1) / bands);
+            band(padded, output, kernelWidth, kernelHeight, y0, y1);
+        }
+    });
+    return output;
+}
+
+cv::Mat BoxFilter::stackedGaussian(const cv::Mat& input, double sigma)
+{
+    if (input.empty()) return cv::Mat();
+    const int passes = 3;
+
+    // Odd widths wl and wl + 2, m passes of the smaller, chosen so the summed box
+    // variances (w^2 - 1) / 12 match sigma^2 as closely as possible
+    double var12 = 12.0 * sigma * sigma;
+    int wl = (int)std::floor(std::sqrt(var12 / passes + 1.0));
+    if (wl % 2 == 0) wl--;
+    wl = std::max(wl, 1);
+    int wu = wl + 2;
+    int m = (int)std::lround((var12 - passes * wl * wl - 4.0 * passes * wl - 3.0 * passes) / (-4.0 * wl - 4.0));
+
+    cv::Mat work;
+    input.convertTo(work, CV_32F);
+    for (int i = 0; i < passes; i++)
+    {
+        int w = (i < m) ? wl : wu;
+        work = apply(work, w, w);
+    }
+
+    if (input.depth() != CV_32F) work.convertTo(work, input.depth());
+    return work;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+
+// Running-sum box filter: a column sum slides down the rows and a row sum slides
+// along each line, so every output pixel costs two additions and two subtractions
+// per channel whatever the window size. Windows may exceed the image (for
+// background estimation); borders are BORDER_REFLECT_101 and the anchor is
+// centred, matching cv::blur.
+// Integer inputs accumulate in 32 bits while kernel area * max value fits,
+// 64 bits otherwise; float inputs accumulate in double to avoid drift.
+class BoxFilter
+{
+public:
+    // kernelHeight <= 0 means a square window. Output keeps the input type.
+    static cv::Mat apply(const cv::Mat& input, int kernelWidth, int kernelHeight = 0);
+
+    // Gaussian approximation from three stacked boxes (widths per Kovesi 2010);
+    // runs in CV_32F and returns the input type
+    static cv::Mat stackedGaussian(const cv::Mat& input, double sigma);
+};
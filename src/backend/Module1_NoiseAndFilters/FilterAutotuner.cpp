@@ -0,0 +1,156 @@
+#include "FilterAutotuner.h"
+#include "LowPassFilters.h"
+#include "NoiseGenerator.h"
+#include "../Module2_EdgesAndEntropy/QualityMetrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+
+const char* const FILTERS[] = { "Average", "Gaussian", "Median" };
+
+cv::Scalar filterColor(const std::string& filter)
+{
+    if (filter == "Average")  return cv::Scalar(255, 180, 60);   // azure
+    if (filter == "Gaussian") return cv::Scalar(80, 220, 120);   // green
+    return cv::Scalar(60, 170, 255);                             // amber
+}
+
+cv::Mat runFilter(const std::string& filter, const cv::Mat& input, int k)
+{
+    if (filter == "Average")  return LowPassFilters::applyAverage(input, k);
+    if (filter == "Gaussian") return LowPassFilters::applyGaussian(input, k);
+    return LowPassFilters::applyMedian(input, k);
+}
+
+} // namespace
+
+int FilterAutotuner::trialCount(int maxKernelSize)
+{
+    return (int)(sizeof(FILTERS) / sizeof(FILTERS[0])) * std::max(0, (maxKernelSize - 1) / 2);
+}
+
+FilterAutotuner::Report FilterAutotuner::run(const cv::Mat& reference, double noiseSigma, int maxKernelSize,
+                                             uint64_t seed, std::atomic<int>* done)
+{
+    Report report;
+    if (reference.empty()) return report;
+
+    cv::Mat noisy = NoiseGenerator::addGaussianNoise(reference, noiseSigma, seed);
+    for (const char* filter : FILTERS)
+        for (int k = 3; k <= maxKernelSize; k += 2)
+        {
+            Trial t;
+            t.filter = filter;
+            t.kernelSize = k;
+            report.trials.push_back(t);
+        }
+
+    // Warm up lazily initialised state (Gaussian cost calibration, FFT plans)
+    // so the first timed trial does not pay for it
+    LowPassFilters::applyGaussian(noisy, 3);
+
+    // Trials run one after another so each time is an uncontended Apply with the
+    // filter's own parallel loops; only the scoring (itself a parallel pass over
+    // row bands) happens between timings.
+    for (Trial& t : report.trials)
+    {
+        int64 start = cv::getTickCount();
+        cv::Mat filtered = runFilter(t.filter, noisy, t.kernelSize);
+        t.ms = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+
+        QualityMetrics::Result q = QualityMetrics::compare(reference, filtered);
+        t.psnr = q.psnr;
+        t.ssim = q.ssim;
+        if (done) ++*done;
+    }
+
+    double bestSsim = -1.0;
+    for (Trial& t : report.trials)
+    {
+        t.pareto = std::none_of(report.trials.begin(), report.trials.end(), [&t](const Trial& o) {
+            return o.ms <= t.ms && o.ssim >= t.ssim && (o.ms < t.ms || o.ssim > t.ssim);
+        });
+        bestSsim = std::max(bestSsim, t.ssim);
+    }
+    for (int i = 0; i < (int)report.trials.size(); i++)
+    {
+        const Trial& t = report.trials[i];
+        if (!t.pareto || t.ssim < bestSsim - 0.005) continue;
+        if (report.recommended < 0 || t.ms < report.trials[report.recommended].ms) report.recommended = i;
+    }
+
+    report.plot = plotPareto(report.trials, report.recommended);
+    return report;
+}
+
+cv::Mat FilterAutotuner::plotPareto(const std::vector<Trial>& trials, int recommended)
+{
+    const int plot_w = 512, plot_h = 400, margin = 36;
+    cv::Mat plot(plot_h, plot_w, CV_8UC3, cv::Scalar(22, 24, 29));
+
+    for (int i = 0; i <= plot_h; i += 50)
+        cv::line(plot, cv::Point(0, i), cv::Point(plot_w, i), cv::Scalar(45, 48, 55), 1);
+    for (int i = 0; i <= plot_w; i += 64)
+        cv::line(plot, cv::Point(i, 0), cv::Point(i, plot_h), cv::Scalar(45, 48, 55), 1);
+    if (trials.empty()) return plot;
+
+    // Time on a log axis (kernels span orders of magnitude), SSIM linear
+    double tMin = 1e300, tMax = 0, sMin = 1e300, sMax = -1e300;
+    for (const Trial& t : trials)
+    {
+        double lt = std::log10(std::max(t.ms, 1e-3));
+        tMin = std::min(tMin, lt); tMax = std::max(tMax, lt);
+        sMin = std::min(sMin, t.ssim); sMax = std::max(sMax, t.ssim);
+    }
+    if (tMax - tMin < 1e-6) tMax = tMin + 1;
+    if (sMax - sMin < 1e-6) sMax = sMin + 1e-3;
+
+    auto toPoint = [&](const Trial& t) {
+        double lt = std::log10(std::max(t.ms, 1e-3));
+        int x = margin + cvRound((lt - tMin) / (tMax - tMin) * (plot_w - 2 * margin));
+        int y = plot_h - margin - cvRound((t.ssim - sMin) / (sMax - sMin) * (plot_h - 2 * margin));
+        return cv::Point(x, y);
+    };
+
+    // Pareto front, fastest to slowest
+    std::vector<const Trial*> front;
+    for (const Trial& t : trials) if (t.pareto) front.push_back(&t);
+    std::sort(front.begin(), front.end(), [](const Trial* a, const Trial* b) { return a->ms < b->ms; });
+    for (size_t i = 1; i < front.size(); i++)
+        cv::line(plot, toPoint(*front[i - 1]), toPoint(*front[i]), cv::Scalar(255, 50, 200), 2, cv::LINE_AA);
+
+    for (const Trial& t : trials)
+    {
+        cv::Scalar color = filterColor(t.filter);
+        cv::circle(plot, toPoint(t), t.pareto ? 5 : 3, color, cv::FILLED, cv::LINE_AA);
+    }
+    for (const Trial* t : front)
+    {
+        char label[32];
+        std::snprintf(label, sizeof(label), "%c%d", t->filter[0], t->kernelSize);
+        cv::putText(plot, label, toPoint(*t) + cv::Point(6, -6), cv::FONT_HERSHEY_SIMPLEX, 0.35,
+                    cv::Scalar(220, 220, 220), 1, cv::LINE_AA);
+    }
+    if (recommended >= 0)
+        cv::circle(plot, toPoint(trials[recommended]), 9, cv::Scalar(255, 255, 255), 1, cv::LINE_AA);
+
+    // Axis captions and legend
+    char caption[64];
+    std::snprintf(caption, sizeof(caption), "time %.2f - %.0f ms (log)", std::pow(10.0, tMin), std::pow(10.0, tMax));
+    cv::putText(plot, caption, cv::Point(margin, plot_h - 10), cv::FONT_HERSHEY_SIMPLEX, 0.4,
+                cv::Scalar(160, 160, 160), 1, cv::LINE_AA);
+    std::snprintf(caption, sizeof(caption), "SSIM %.3f - %.3f", sMin, sMax);
+    cv::putText(plot, caption, cv::Point(8, 18), cv::FONT_HERSHEY_SIMPLEX, 0.4,
+                cv::Scalar(160, 160, 160), 1, cv::LINE_AA);
+    int lx = plot_w - 110;
+    for (int i = 0; i < 3; i++)
+    {
+        cv::circle(plot, cv::Point(lx, 16 + 16 * i), 4, filterColor(FILTERS[i]), cv::FILLED, cv::LINE_AA);
+        cv::putText(plot, FILTERS[i], cv::Point(lx + 10, 20 + 16 * i), cv::FONT_HERSHEY_SIMPLEX, 0.4,
+                    cv::Scalar(200, 200, 200), 1, cv::LINE_AA);
+    }
+    return plot;
+}
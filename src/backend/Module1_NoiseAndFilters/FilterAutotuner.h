@@ -0,0 +1,40 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Speed vs quality sweep for the Task 2 low-pass filters. A clean reference gets
+// seeded Gaussian noise, every (filter, kernel) pair denoises it, and each trial
+// records wall time plus PSNR/SSIM against the reference.
+// Trials run sequentially, not concurrently: each is timed on its own with the
+// filter's internal parallel loops, so times match an interactive Apply and are
+// free of contention from other trials. Callers keep the sweep off the GUI thread.
+class FilterAutotuner
+{
+public:
+    struct Trial
+    {
+        std::string filter;   // "Average", "Gaussian" or "Median" (Task 2 combo names)
+        int kernelSize = 3;
+        double ms = 0.0;
+        double psnr = 0.0;
+        double ssim = 0.0;
+        bool pareto = false;  // no other trial is both faster and better (SSIM)
+    };
+
+    struct Report
+    {
+        std::vector<Trial> trials;
+        int recommended = -1; // fastest Pareto trial within 0.005 SSIM of the best
+        cv::Mat plot;         // SSIM vs time scatter with the Pareto front
+    };
+
+    // `done`, when given, counts finished trials (for progress polling)
+    static Report run(const cv::Mat& reference, double noiseSigma = 10.0, int maxKernelSize = 15,
+                      uint64_t seed = 1, std::atomic<int>* done = nullptr);
+    static int trialCount(int maxKernelSize = 15);
+
+    static cv::Mat plotPareto(const std::vector<Trial>& trials, int recommended);
+};
@@ -0,0 +1,91 @@
+#include "GuidedFilter.h"
+#include "BoxFilter.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+
+// Scale that maps the full range of an integer depth onto [0, 1]
+double unitScale(int depth)
+{
+    if (depth == CV_8U)  return 1.0 / 255.0;
+    if (depth == CV_16U) return 1.0 / 65535.0;
+    return 1.0;
+}
+
+cv::Mat toUnitFloat(const cv::Mat& img)
+{
+    cv::Mat out;
+    img.convertTo(out, CV_32F, unitScale(img.depth()));
+    return out;
+}
+
+// Single-channel guide matching the input size
+cv::Mat prepareGuide(const cv::Mat& input, const cv::Mat& guide)
+{
+    cv::Mat g = guide.empty() ? input : guide;
+    if (g.channels() == 3) cv::cvtColor(g, g, cv::COLOR_BGR2GRAY);
+    else if (g.channels() == 4) cv::cvtColor(g, g, cv::COLOR_BGRA2GRAY);
+    g = toUnitFloat(g);
+    if (g.size() != input.size()) cv::resize(g, g, input.size(), 0, 0, cv::INTER_LINEAR);
+    return g;
+}
+
+} // namespace
+
+cv::Mat GuidedFilter::apply(const cv::Mat& input, const cv::Mat& guide, int radius, double eps,
+                            int subsample)
+{
+    if (input.empty()) return cv::Mat();
+    CV_Assert(radius >= 1 && eps > 0);
+    subsample = std::max(1, std::min(subsample, radius));
+
+    const int cn = input.channels();
+    cv::Mat I = prepareGuide(input, guide);
+    cv::Mat p = toUnitFloat(input);
+
+    cv::Mat Is = I, ps = p;
+    if (subsample > 1)
+    {
+        cv::Size small((I.cols + subsample - 1) / subsample, (I.rows + subsample - 1) / subsample);
+        cv::resize(I, Is, small, 0, 0, cv::INTER_AREA);
+        cv::resize(p, ps, small, 0, 0, cv::INTER_AREA);
+    }
+    const int k = 2 * std::max(1, radius / subsample) + 1;
+
+    // The guide is broadcast over the input channels so every product below is
+    // one element-wise call
+    cv::Mat IsN;
+    cv::merge(std::vector<cv::Mat>(cn, Is), IsN);
+
+    cv::Mat meanI = BoxFilter::apply(Is, k);
+    cv::Mat varI = BoxFilter::apply(Is.mul(Is), k) - meanI.mul(meanI);
+    cv::Mat meanP = BoxFilter::apply(ps, k);
+    cv::Mat meanIp = BoxFilter::apply(IsN.mul(ps), k);
+
+    cv::Mat meanIN, denomN;
+    cv::merge(std::vector<cv::Mat>(cn, meanI), meanIN);
+    cv::merge(std::vector<cv::Mat>(cn, varI + eps), denomN);
+
+    // Per-window linear model q = a * I + b, averaged over the windows covering a pixel
+    cv::Mat a, b;
+    cv::divide(meanIp - meanIN.mul(meanP), denomN, a);
+    b = meanP - a.mul(meanIN);
+    cv::Mat meanA = BoxFilter::apply(a, k);
+    cv::Mat meanB = BoxFilter::apply(b, k);
+
+    if (subsample > 1)
+    {
+        cv::resize(meanA, meanA, input.size(), 0, 0, cv::INTER_LINEAR);
+        cv::resize(meanB, meanB, input.size(), 0, 0, cv::INTER_LINEAR);
+    }
+
+    cv::Mat IN;
+    cv::merge(std::vector<cv::Mat>(cn, I), IN);
+    cv::Mat q = meanA.mul(IN) + meanB;
+
+    cv::Mat output;
+    q.convertTo(output, input.depth(), 1.0 / unitScale(input.depth()));
+    return output;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+
+// Edge-preserving smoothing (He, Sun & Tang guided filter, grayscale guide).
+// Every step is a BoxFilter mean, so cost per pixel does not depend on radius.
+//   guide     - empty means self-guided; colour guides are reduced to luminance
+//               and resized to the input if needed
+//   eps       - regularisation on intensities scaled to [0, 1]; edges with a
+//               local variance well above eps are kept
+//   subsample - > 1 computes the linear coefficients at 1/subsample resolution
+//               and upsamples them (fast guided filter), for previews
+// Output keeps the input type.
+class GuidedFilter
+{
+public:
+    static cv::Mat apply(const cv::Mat& input, const cv::Mat& guide, int radius, double eps,
+                         int subsample = 1);
+};
@@ -1,22 +1,63 @@
 #include "LowPassFilters.h"
+#include "BoxFilter.h"
+#include "GuidedFilter.h"
+#include "MedianFilter.h"
+#include "../core/Convolution.h"
+#include "../core/GaussianEngine.h"
+#include <algorithm>
 
 cv::Mat LowPassFilters::applyAverage(const cv::Mat& input, int kernelSize)
 {
-    cv::Mat output;
-    cv::blur(input, output, cv::Size(kernelSize, kernelSize));
-    return output;
+    // Running sums: same result as cv::blur, cost independent of the window
+    return BoxFilter::apply(input, kernelSize);
 }
 
-cv::Mat LowPassFilters::applyGaussian(const cv::Mat& input, int kernelSize)
+cv::Mat LowPassFilters::applyGaussian(const cv::Mat& input, int kernelSize, bool fastPreview)
 {
-    cv::Mat output;
-    cv::GaussianBlur(input, output, cv::Size(kernelSize, kernelSize), 0);
-    return output;
+    // Same sigma cv::GaussianBlur derives from the kernel size; the engine then
+    // picks spatial, recursive or FFT so large kernels stop scaling with area.
+    double sigma = 0.3 * ((kernelSize - 1) * 0.5 - 1) + 0.8;
+    if (fastPreview) return BoxFilter::stackedGaussian(input, sigma);
+    return GaussianEngine::blur(input, sigma);
 }
 
 cv::Mat LowPassFilters::applyMedian(const cv::Mat& input, int kernelSize)
 {
+    // cv::medianBlur's sorting networks win for tiny windows; beyond 5x5 (and for
+    // any 16-bit window it does not support) use the histogram median.
+    if (kernelSize > 5 && (input.depth() == CV_8U || input.depth() == CV_16U))
+        return MedianFilter::apply(input, kernelSize);
+
     cv::Mat output;
     cv::medianBlur(input, output, kernelSize);
     return output;
+}
+
+cv::Mat LowPassFilters::applyAdaptiveMedian(const cv::Mat& input, int kernelSize)
+{
+    return MedianFilter::applyAdaptive(input, kernelSize);
+}
+
+cv::Mat LowPassFilters::applyGuided(const cv::Mat& input, const cv::Mat& guide, int kernelSize,
+                                    double eps, bool fastPreview)
+{
+    return GuidedFilter::apply(input, guide, std::max(1, kernelSize / 2), eps, fastPreview ? 4 : 1);
+}
+
+cv::Mat LowPassFilters::applyRecursiveGaussian(const cv::Mat& input, double sigma)
+{
+    return GaussianEngine::blur(input, sigma, sigma, GaussianEngine::RECURSIVE);
+}
+
+cv::Mat LowPassFilters::applyKernel(const cv::Mat& input, const cv::Mat& kernel)
+{
+    return Convolution::apply(input, kernel);
+}
+
+cv::Mat LowPassFilters::applyDisk(const cv::Mat& input, int kernelSize)
+{
+    cv::Mat disk = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(kernelSize, kernelSize));
+    cv::Mat kernel;
+    disk.convertTo(kernel, CV_32F, 1.0 / cv::countNonZero(disk));
+    return applyKernel(input, kernel);
 }
\ No newline at end of file
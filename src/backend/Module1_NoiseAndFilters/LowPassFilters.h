@@ -5,6 +5,26 @@ class LowPassFilters
 {
 public:
     static cv::Mat applyAverage(const cv::Mat& input, int kernelSize);
-    static cv::Mat applyGaussian(const cv::Mat& input, int kernelSize);
+    // fastPreview approximates the Gaussian with three stacked box filters
+    static cv::Mat applyGaussian(const cv::Mat& input, int kernelSize, bool fastPreview = false);
     static cv::Mat applyMedian(const cv::Mat& input, int kernelSize);
+
+    // Impulse-noise removal that only touches outlier pixels; kernelSize is the
+    // largest window a pixel may grow to
+    static cv::Mat applyAdaptiveMedian(const cv::Mat& input, int kernelSize);
+
+    // Edge-preserving guided filter, radius = kernelSize / 2; an empty guide means
+    // the input guides itself. fastPreview fits the model at quarter resolution.
+    static cv::Mat applyGuided(const cv::Mat& input, const cv::Mat& guide, int kernelSize,
+                               double eps, bool fastPreview = false);
+
+    // IIR Gaussian driven by sigma directly; cost per pixel does not depend on sigma
+    static cv::Mat applyRecursiveGaussian(const cv::Mat& input, double sigma);
+
+    // Arbitrary kernel (filter2D semantics); large kernels run as tiled FFT overlap-add
+    static cv::Mat applyKernel(const cv::Mat& input, const cv::Mat& kernel);
+
+    // Lens-style blur with a flat circular kernel of diameter kernelSize; not
+    // separable, so large disks go through the FFT path of applyKernel
+    static cv::Mat applyDisk(const cv::Mat& input, int kernelSize);
 };
\ No newline at end of file
@@ -0,0 +1,305 @@
+#include "MedianFilter.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+
+// Upper bound on the 16-bit column histograms held by all bands at once
+const size_t MAX_COLUMN_HISTOGRAM_BYTES = (size_t)256 << 20;
+
+// Output rows [y0, y1) of an 8-bit plane. `padded` carries r replicated pixels on
+// every side, so output (y, x) sees padded rows y..y+2r and columns x..x+2r.
+void medianBand8u(const cv::Mat& padded, cv::Mat& dst, int r, int y0, int y1)
+{
+    const int W = dst.cols, PW = padded.cols, d = 2 * r + 1;
+    const uint32_t rank = (uint32_t)d * d / 2;
+
+    // Column histograms over the d rows of the current window
+    std::vector<uint16_t> colCoarse((size_t)PW * 16, 0), colFine((size_t)PW * 256, 0);
+    auto addRow = [&](const uchar* row) {
+        for (int c = 0; c < PW; c++) { colCoarse[c * 16 + (row[c] >> 4)]++; colFine[c * 256 + row[c]]++; }
+    };
+    auto removeRow = [&](const uchar* row) {
+        for (int c = 0; c < PW; c++) { colCoarse[c * 16 + (row[c] >> 4)]--; colFine[c * 256 + row[c]]--; }
+    };
+    for (int py = y0; py < y0 + d; py++) addRow(padded.ptr<uchar>(py));
+
+    uint32_t coarse[16];
+    uint32_t fine[16][16];
+    int lastUpdated[16];
+
+    for (int y = y0; y < y1; y++)
+    {
+        if (y > y0)
+        {
+            removeRow(padded.ptr<uchar>(y - 1));
+            addRow(padded.ptr<uchar>(y + 2 * r));
+        }
+
+        std::fill(coarse, coarse + 16, 0u);
+        for (int c = 0; c < d; c++)
+            for (int b = 0; b < 16; b++) coarse[b] += colCoarse[c * 16 + b];
+        std::fill(lastUpdated, lastUpdated + 16, -1);
+
+        uchar* out = dst.ptr<uchar>(y);
+        for (int x = 0; x < W; x++)
+        {
+            if (x > 0)
+            {
+                const uint16_t* in = &colCoarse[(x + 2 * r) * 16];
+                const uint16_t* gone = &colCoarse[(x - 1) * 16];
+                for (int b = 0; b < 16; b++) coarse[b] = coarse[b] + in[b] - gone[b];
+            }
+
+            uint32_t sum = 0;
+            int b = 0;
+            while (sum + coarse[b] <= rank) sum += coarse[b++];
+
+            // Fine bins are only brought up to date for the bucket that holds the
+            // median: slide from where it was last used, or rebuild if that is further.
+            uint32_t* F = fine[b];
+            if (lastUpdated[b] < 0 || x - lastUpdated[b] > r)
+            {
+                std::fill(F, F + 16, 0u);
+                for (int c = x; c < x + d; c++)
+                {
+                    const uint16_t* f = &colFine[c * 256 + b * 16];
+                    for (int i = 0; i < 16; i++) F[i] += f[i];
+                }
+            }
+            else
+            {
+                for (int xi = lastUpdated[b] + 1; xi <= x; xi++)
+                {
+                    const uint16_t* in = &colFine[(xi + 2 * r) * 256 + b * 16];
+                    const uint16_t* gone = &colFine[(xi - 1) * 256 + b * 16];
+                    for (int i = 0; i < 16; i++) F[i] = F[i] + in[i] - gone[i];
+                }
+            }
+            lastUpdated[b] = x;
+
+            int v = 0;
+            while (sum + F[v] <= rank) sum += F[v++];
+            out[x] = (uchar)(b * 16 + v);
+        }
+    }
+}
+
+// 16-bit variant of the same structure with 256 coarse x 256 fine bins, over
+// output columns [x0, x0 + stripWidth) at a time so only stripWidth + 2r column
+// histograms of 64K counters exist. CountT holds one column's counts (at most d).
+template <typename CountT>
+void medianBand16u(const cv::Mat& padded, cv::Mat& dst, int r, int y0, int y1, int stripWidth)
+{
+    const int W = dst.cols, d = 2 * r + 1;
+    const uint32_t rank = (uint32_t)d * d / 2;
+    const int maxCols = std::min(W, stripWidth) + 2 * r;
+
+    std::vector<CountT> colCoarse((size_t)maxCols * 256, 0), colFine((size_t)maxCols * 65536, 0);
+    std::vector<uint32_t> fine((size_t)256 * 256);
+    uint32_t coarse[256], leftCoarse[256];
+    int lastUpdated[256];
+
+    for (int x0 = 0; x0 < W; x0 += stripWidth)
+    {
+        const int S = std::min(stripWidth, W - x0), C = S + 2 * r;
+        auto addRow = [&](const uint16_t* row) {
+            for (int c = 0; c < C; c++) { colCoarse[c * 256 + (row[c] >> 8)]++; colFine[(size_t)c * 65536 + row[c]]++; }
+        };
+        auto removeRow = [&](const uint16_t* row) {
+            for (int c = 0; c < C; c++) { colCoarse[c * 256 + (row[c] >> 8)]--; colFine[(size_t)c * 65536 + row[c]]--; }
+        };
+
+        // Coarse histogram of the strip's first window, slid down with the rows
+        std::fill(leftCoarse, leftCoarse + 256, 0u);
+        for (int py = y0; py < y0 + d; py++)
+        {
+            const uint16_t* row = padded.ptr<uint16_t>(py) + x0;
+            addRow(row);
+            for (int c = 0; c < d; c++) leftCoarse[row[c] >> 8]++;
+        }
+
+        for (int y = y0; y < y1; y++)
+        {
+            if (y > y0)
+            {
+                const uint16_t* gone = padded.ptr<uint16_t>(y - 1) + x0;
+                const uint16_t* in = padded.ptr<uint16_t>(y + 2 * r) + x0;
+                removeRow(gone);
+                addRow(in);
+                for (int c = 0; c < d; c++) { leftCoarse[gone[c] >> 8]--; leftCoarse[in[c] >> 8]++; }
+            }
+
+            std::copy(leftCoarse, leftCoarse + 256, coarse);
+            std::fill(lastUpdated, lastUpdated + 256, -1);
+
+            uint16_t* out = dst.ptr<uint16_t>(y) + x0;
+            for (int x = 0; x < S; x++)
+            {
+                if (x > 0)
+                {
+                    const CountT* in = &colCoarse[(x + 2 * r) * 256];
+                    const CountT* gone = &colCoarse[(x - 1) * 256];
+                    for (int b = 0; b < 256; b++) coarse[b] = coarse[b] + in[b] - gone[b];
+                }
+
+                uint32_t sum = 0;
+                int b = 0;
+                while (sum + coarse[b] <= rank) sum += coarse[b++];
+
+                uint32_t* F = &fine[b * 256];
+                if (lastUpdated[b] < 0 || x - lastUpdated[b] > r)
+                {
+                    std::fill(F, F + 256, 0u);
+                    for (int c = x; c < x + d; c++)
+                    {
+                        const CountT* f = &colFine[(size_t)c * 65536 + b * 256];
+                        for (int i = 0; i < 256; i++) F[i] += f[i];
+                    }
+                }
+                else
+                {
+                    for (int xi = lastUpdated[b] + 1; xi <= x; xi++)
+                    {
+                        const CountT* in = &colFine[(size_t)(xi + 2 * r) * 65536 + b * 256];
+                        const CountT* gone = &colFine[(size_t)(xi - 1) * 65536 + b * 256];
+                        for (int i = 0; i < 256; i++) F[i] = F[i] + in[i] - gone[i];
+                    }
+                }
+                lastUpdated[b] = x;
+
+                int v = 0;
+                while (sum + F[v] <= rank) sum += F[v++];
+                out[x] = (uint16_t)(b * 256 + v);
+            }
+        }
+
+        // Empty the column histograms again by removing the last window
+        for (int py = y1 - 1; py < y1 - 1 + d; py++) removeRow(padded.ptr<uint16_t>(py) + x0);
+    }
+}
+
+// Rows [y0, y1) of the adaptive median; `padded` has rmax replicated pixels per side
+template <typename T>
+void adaptiveRows(const cv::Mat& padded, const cv::Mat& src, cv::Mat& dst, int rmax, int y0, int y1)
+{
+    std::vector<T> window;
+    window.reserve((size_t)(2 * rmax + 1) * (2 * rmax + 1));
+
+    for (int y = y0; y < y1; y++)
+    {
+        const T* in = src.ptr<T>(y);
+        T* out = dst.ptr<T>(y);
+        for (int x = 0; x < src.cols; x++)
+        {
+            const T z = in[x];
+            T lo = z, hi = z;
+            for (int dy = -1; dy <= 1; dy++)
+            {
+                const T* row = padded.ptr<T>(y + rmax + dy) + x + rmax;
+                for (int dx = -1; dx <= 1; dx++) { lo = std::min(lo, row[dx]); hi = std::max(hi, row[dx]); }
+            }
+            if ((lo < z && z < hi) || lo == hi) continue;
+
+            // Impulse candidate: grow the window until the median is trustworthy
+            T med = z;
+            for (int r = 1; r <= rmax; r++)
+            {
+                window.clear();
+                lo = hi = padded.ptr<T>(y + rmax)[x + rmax];
+                for (int dy = -r; dy <= r; dy++)
+                {
+                    const T* row = padded.ptr<T>(y + rmax + dy) + x + rmax;
+                    for (int dx = -r; dx <= r; dx++)
+                    {
+                        T v = row[dx];
+                        window.push_back(v);
+                        lo = std::min(lo, v);
+                        hi = std::max(hi, v);
+                    }
+                }
+                auto mid = window.begin() + window.size() / 2;
+                std::nth_element(window.begin(), mid, window.end());
+                med = *mid;
+                if (lo < med && med < hi) break;
+            }
+            out[x] = (lo < z && z < hi) ? z : med;
+        }
+    }
+}
+
+} // namespace
+
+cv::Mat MedianFilter::apply(const cv::Mat& input, int kernelSize)
+{
+    CV_Assert(input.depth() == CV_8U || input.depth() == CV_16U);
+    CV_Assert(kernelSize >= 3 && kernelSize % 2 == 1);
+    const int r = kernelSize / 2;
+
+    std::vector<cv::Mat> planes;
+    cv::split(input, planes);
+
+    // Bands of at least 2r rows so the per-band histogram set-up stays amortised
+    const int minBandRows = std::max(32, 2 * r);
+    int bands = std::max(1, std::min(input.rows / minBandRows, cv::getNumThreads() * 4));
+
+    // 16-bit strips about four kernels wide keep the per-row set-up (the first
+    // window's coarse and fine levels) amortised; each band holds its own column
+    // histograms, so large kernels run fewer bands at once
+    const int d = 2 * r + 1;
+    const int stripWidth = std::min(input.cols, 4 * d);
+    const size_t counterBytes = (d <= 255) ? 1 : 2;
+    const size_t bandBytes = (size_t)(stripWidth + 2 * r) * (65536 + 256) * counterBytes;
+    if (input.depth() == CV_16U)
+        bands = (int)std::max<size_t>(1, std::min<size_t>(bands, MAX_COLUMN_HISTOGRAM_BYTES / bandBytes));
+
+    for (cv::Mat& plane : planes)
+    {
+        cv::Mat padded, filtered(plane.size(), plane.type());
+        cv::copyMakeBorder(plane, padded, r, r, r, r, cv::BORDER_REPLICATE);
+
+        cv::parallel_for_(cv::Range(0, bands), [&](const cv::Range& range) {
+            for (int band = range.start; band < range.end; band++)
+            {
+                int y0 = (int)((int64)plane.rows * band / bands);
+                int y1 = (int)((int64)plane.rows * (band + 1) / bands);
+                if (plane.depth() == CV_8U) medianBand8u(padded, filtered, r, y0, y1);
+                else if (d <= 255)          medianBand16u<uint8_t>(padded, filtered, r, y0, y1, stripWidth);
+                else                        medianBand16u<uint16_t>(padded, filtered, r, y0, y1, stripWidth);
+            }
+        });
+        plane = filtered;
+    }
+
+    cv::Mat output;
+    cv::merge(planes, output);
+    return output;
+}
+
+cv::Mat MedianFilter::applyAdaptive(const cv::Mat& input, int maxKernelSize)
+{
+    CV_Assert(input.depth() == CV_8U || input.depth() == CV_16U);
+    CV_Assert(maxKernelSize >= 3);
+    const int rmax = maxKernelSize / 2;
+
+    std::vector<cv::Mat> planes;
+    cv::split(input, planes);
+
+    for (cv::Mat& plane : planes)
+    {
+        cv::Mat padded, filtered = plane.clone();
+        cv::copyMakeBorder(plane, padded, rmax, rmax, rmax, rmax, cv::BORDER_REPLICATE);
+
+        cv::parallel_for_(cv::Range(0, plane.rows), [&](const cv::Range& range) {
+            if (plane.depth() == CV_8U) adaptiveRows<uchar>(padded, plane, filtered, rmax, range.start, range.end);
+            else                        adaptiveRows<uint16_t>(padded, plane, filtered, rmax, range.start, range.end);
+        });
+        plane = filtered;
+    }
+
+    cv::Mat output;
+    cv::merge(planes, output);
+    return output;
+}
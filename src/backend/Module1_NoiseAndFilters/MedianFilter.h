@@ -0,0 +1,27 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+
+// Histogram-based median for large windows on 8-bit and 16-bit data, after
+// Perreault & Hebert: per-column histograms slid down the rows, and a two-level
+// kernel histogram slid along each row whose fine level is only brought up to
+// date for the bucket holding the median. Per-pixel cost does not depend on the
+// radius.
+//   8U : 16 coarse x 16 fine bins.
+//   16U: 256 coarse x 256 fine bins. A full column histogram is 64K counters, so
+//        rows are processed in vertical strips about 4 kernels wide (bounding the
+//        column histograms to ~5 kernel widths) and fewer bands run at once for
+//        large kernels, to keep the total near 256 MB.
+// Borders are replicated (same as cv::medianBlur). Rows are split into bands
+// that run in parallel, each with its own histograms.
+class MedianFilter
+{
+public:
+    static cv::Mat apply(const cv::Mat& input, int kernelSize);
+
+    // Adaptive median for impulse noise. Pixels strictly inside the range of their
+    // 3x3 neighbourhood (or in a flat patch) are copied untouched; the rest grow
+    // their window until its median is not itself an extreme, up to maxKernelSize,
+    // and are replaced by that median unless they turn out not to be extremes.
+    // Cost therefore follows the amount of noise rather than the image size.
+    static cv::Mat applyAdaptive(const cv::Mat& input, int maxKernelSize);
+};
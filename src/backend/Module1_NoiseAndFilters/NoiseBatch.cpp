@@ -0,0 +1,124 @@
+#include "NoiseBatch.h"
+#include "NoiseGenerator.h"
+#include "../core/EncodeQueue.h"
+#include <opencv2/core/utils/logger.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+namespace
+{
+
+const char* typeName(NoiseBatch::Type type)
+{
+    switch (type)
+    {
+        case NoiseBatch::UNIFORM:           return "uniform";
+        case NoiseBatch::ZERO_MEAN_UNIFORM: return "zero-mean";
+        case NoiseBatch::GAUSSIAN:          return "gaussian";
+        default:                            return "salt-pepper";
+    }
+}
+
+bool parseType(const std::string& name, NoiseBatch::Type& type)
+{
+    if (name == "uniform")                           type = NoiseBatch::UNIFORM;
+    else if (name == "zero-mean")                    type = NoiseBatch::ZERO_MEAN_UNIFORM;
+    else if (name == "gaussian")                     type = NoiseBatch::GAUSSIAN;
+    else if (name == "salt-pepper" || name == "sp")  type = NoiseBatch::SALT_PEPPER;
+    else return false;
+    return true;
+}
+
+} // namespace
+
+bool NoiseBatch::parseSpecs(const std::string& text, std::vector<Spec>& specs, std::string* error)
+{
+    std::istringstream lines(text);
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(lines, line))
+    {
+        lineNo++;
+        std::string::size_type hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+
+        std::istringstream fields(line);
+        std::string name;
+        if (!(fields >> name)) continue;
+
+        Spec spec;
+        std::string extra;
+        if (!parseType(name, spec.type) || !(fields >> spec.intensity >> spec.seed) || (fields >> extra))
+        {
+            if (error) *error = "line " + std::to_string(lineNo) + ": expected \"<type> <intensity> <seed>\"";
+            return false;
+        }
+        specs.push_back(spec);
+    }
+    return true;
+}
+
+std::string NoiseBatch::label(const Spec& spec)
+{
+    std::ostringstream out;
+    out << typeName(spec.type) << "_i" << spec.intensity << "_s" << spec.seed;
+    return out.str();
+}
+
+cv::Mat NoiseBatch::generate(const cv::Mat& input, const Spec& spec)
+{
+    switch (spec.type)
+    {
+        case UNIFORM:           return NoiseGenerator::addUniformNoise(input, (int)spec.intensity, spec.seed);
+        case ZERO_MEAN_UNIFORM: return NoiseGenerator::addZeroMeanUniformNoise(input, (int)spec.intensity, spec.seed);
+        case GAUSSIAN:          return NoiseGenerator::addGaussianNoise(input, spec.intensity / 2.0, spec.seed);
+        default:                return NoiseGenerator::addSaltPepperNoise(input, spec.intensity / 100.0, spec.seed);
+    }
+}
+
+int NoiseBatch::exportVariants(const cv::Mat& input, const std::vector<Spec>& specs,
+                               const std::string& directory, const std::string& prefix, Timing* timing,
+                               std::atomic<int>* done, Format format)
+{
+    int64 start = cv::getTickCount();
+    if (input.empty() || specs.empty()) return 0;
+
+    if (format == PNM && input.channels() != 1 && input.channels() != 3) format = PNG;
+    const std::string extension = (format == PNG) ? ".png" : (input.channels() == 1 ? ".pgm" : ".ppm");
+    std::vector<int> params = (format == PNG) ? std::vector<int>{cv::IMWRITE_PNG_COMPRESSION, 1}
+                                              : std::vector<int>{cv::IMWRITE_PXM_BINARY, 1};
+
+    // Variants are independent, so parallelism is across specs; the per-image
+    // row loops inside NoiseGenerator then run serially on each worker. Time
+    // spent generating is summed apart from time blocked on the encoders.
+    EncodeQueue queue(0, 32, params);
+    std::atomic<int64> generateTicks{0};
+    cv::parallel_for_(cv::Range(0, (int)specs.size()), [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; i++)
+        {
+            char index[16];
+            std::snprintf(index, sizeof(index), "%04d", i);
+            int64 t = cv::getTickCount();
+            cv::Mat variant = generate(input, specs[i]);
+            generateTicks += cv::getTickCount() - t;
+            queue.push(directory + "/" + prefix + "_" + index + "_" + label(specs[i]) + extension, variant);
+            if (done) (*done)++;
+        }
+    });
+    queue.finish();
+
+    double ms = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+    double generateMs = generateTicks.load() * 1000.0 / cv::getTickFrequency();
+    int workers = std::max(1, std::min(cv::getNumThreads(), (int)specs.size()));
+    double generateRate = specs.size() * 1000.0 * workers / std::max(generateMs, 1e-3);
+    CV_LOG_INFO(NULL, "NoiseBatch: " << queue.written() << " variants of " << input.cols << "x" << input.rows
+                << " (" << extension << ") in " << ms << " ms (" << queue.written() * 1000.0 / std::max(ms, 1e-3)
+                << " images/s; generation alone " << generateRate << " images/s)");
+    if (timing)
+    {
+        timing->elapsedMs = ms;
+        timing->generateRate = generateRate;
+    }
+    return queue.written();
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Many noisy variants of one source image (denoising datasets). The source is read
+// once and shared; variants are generated in parallel, one per spec, and handed to
+// an EncodeQueue as soon as they are ready, so memory stays bounded by the queue.
+// Throughput is bounded by encoding: PNG (even at level 1) costs far more per
+// megapixel than generating the noise, so thousands of 1 MP variants per second
+// need the uncompressed PNM format. Timing reports both rates.
+class NoiseBatch
+{
+public:
+    enum Type { UNIFORM, ZERO_MEAN_UNIFORM, GAUSSIAN, SALT_PEPPER };
+    // PNM is binary .pgm / .ppm (no compression); 4-channel sources stay PNG
+    enum Format { PNG, PNM };
+
+    struct Timing
+    {
+        double elapsedMs = 0.0;     // wall time of the whole export
+        double generateRate = 0.0;  // images/s the generators alone sustain
+    };
+
+    // Intensity uses the Task 1 slider scale (0-100): uniform range, Gaussian
+    // sigma = intensity / 2, salt & pepper probability = intensity / 100
+    struct Spec
+    {
+        Type type;
+        double intensity;
+        uint64_t seed;
+    };
+
+    // One spec per line: "<type> <intensity> <seed>", type one of uniform,
+    // zero-mean, gaussian, salt-pepper. Blank lines and '#' comments are skipped.
+    // Returns false and sets `error` (with the line number) on a malformed line.
+    static bool parseSpecs(const std::string& text, std::vector<Spec>& specs, std::string* error = nullptr);
+
+    // File-name friendly label, e.g. "gaussian_i20_s7"
+    static std::string label(const Spec& spec);
+
+    static cv::Mat generate(const cv::Mat& input, const Spec& spec);
+
+    // Writes <directory>/<prefix>_<index>_<label>.<ext> for every spec; returns the
+    // number of files written. `done` (if given) counts generated variants and may
+    // be polled from another thread while the batch runs.
+    static int exportVariants(const cv::Mat& input, const std::vector<Spec>& specs,
+                              const std::string& directory, const std::string& prefix = "noisy",
+                              Timing* timing = nullptr, std::atomic<int>* done = nullptr,
+                              Format format = PNG);
+};
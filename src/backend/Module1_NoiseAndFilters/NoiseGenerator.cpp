@@ -1,51 +1,166 @@
 #include "NoiseGenerator.h"
+#include "PhiloxRNG.h"
+#include <algorithm>
+#include <cmath>
 
-cv::Mat NoiseGenerator::addGaussianNoise(const cv::Mat& input, double stddev)
+namespace
 {
-    cv::Mat noise(input.size(), input.type());
-    cv::randn(noise, 0, stddev);
 
-    cv::Mat output;
-    const int signedType = CV_MAKETYPE(CV_16S, input.channels());
-    input.convertTo(output, signedType);
-    noise.convertTo(noise, signedType);
+// Separate streams keep the noise types uncorrelated for the same seed
+enum NoiseStream : uint32_t
+{
+    GAUSSIAN_STREAM = 1, UNIFORM_STREAM = 2, SALT_PEPPER_STREAM = 3, ZERO_MEAN_UNIFORM_STREAM = 4
+};
 
-    cv::addWeighted(output, 1.0, noise, 1.0, 0, output);
-    output.convertTo(output, input.type());
+// dst = saturate(src + noise) in parallel row bands; dst may be src. sample(block,
+// values) turns the four Philox words of a pixel into one offset per channel.
+template <typename T, typename Sample>
+void addNoise(const cv::Mat& src, cv::Mat& dst, uint64_t seed, uint32_t stream, Sample sample)
+{
+    const int cn = src.channels();
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range) {
+        float values[4];
+        for (int y = range.start; y < range.end; y++)
+        {
+            const T* in = src.ptr<T>(y);
+            T* out = dst.ptr<T>(y);
+            for (int x = 0; x < src.cols; x++)
+            {
+                sample(PhiloxRNG::generate((uint64_t)y * src.cols + x, seed, stream), values);
+                for (int c = 0; c < cn; c++) out[x * cn + c] = cv::saturate_cast<T>(in[x * cn + c] + values[c]);
+            }
+        }
+    });
+}
 
-    return output;
+template <typename Sample>
+void addNoise(const cv::Mat& src, cv::Mat& dst, uint64_t seed, uint32_t stream, Sample sample)
+{
+    CV_Assert(src.channels() <= 4);
+    dst.create(src.size(), src.type());
+    switch (src.depth())
+    {
+        case CV_8U:  addNoise<uchar>(src, dst, seed, stream, sample); break;
+        case CV_16U: addNoise<uint16_t>(src, dst, seed, stream, sample); break;
+        case CV_16S: addNoise<int16_t>(src, dst, seed, stream, sample); break;
+        case CV_32F: addNoise<float>(src, dst, seed, stream, sample); break;
+        default: CV_Error(cv::Error::StsUnsupportedFormat, "NoiseGenerator: unsupported depth");
+    }
 }
 
-cv::Mat NoiseGenerator::addUniformNoise(const cv::Mat& input, int intensity)
+void gaussian(const cv::Mat& src, cv::Mat& dst, double stddev, uint64_t seed)
 {
-    cv::Mat noise(input.size(), input.type());
-    cv::randu(noise, 0, intensity);
+    const float sd = (float)stddev;
+    addNoise(src, dst, seed, GAUSSIAN_STREAM, [sd](const PhiloxRNG::Block& r, float* v) {
+        PhiloxRNG::normalPair(r[0], r[1], v[0], v[1]);
+        PhiloxRNG::normalPair(r[2], r[3], v[2], v[3]);
+        for (int c = 0; c < 4; c++) v[c] *= sd;
+    });
+}
 
-    cv::Mat output;
-    cv::add(input, noise, output);
+void uniform(const cv::Mat& src, cv::Mat& dst, int intensity, uint64_t seed)
+{
+    // Integer offsets in [0, intensity), the range cv::randu(noise, 0, intensity) gave
+    const float scale = (float)intensity;
+    addNoise(src, dst, seed, UNIFORM_STREAM, [scale](const PhiloxRNG::Block& r, float* v) {
+        for (int c = 0; c < 4; c++) v[c] = std::floor(PhiloxRNG::uniform(r[c]) * scale);
+    });
+}
 
-    return output;
+void zeroMeanUniform(const cv::Mat& src, cv::Mat& dst, int intensity, uint64_t seed)
+{
+    const float scale = (float)intensity, half = 0.5f * intensity;
+    addNoise(src, dst, seed, ZERO_MEAN_UNIFORM_STREAM, [scale, half](const PhiloxRNG::Block& r, float* v) {
+        for (int c = 0; c < 4; c++) v[c] = PhiloxRNG::uniform(r[c]) * scale - half;
+    });
 }
 
-cv::Mat NoiseGenerator::addSaltPepperNoise(const cv::Mat& input, double amount)
+template <typename T>
+void saltPepper(const cv::Mat& src, cv::Mat& dst, double amount, uint64_t seed, T white)
 {
-    cv::Mat output = input.clone();
-    int numPixels = static_cast<int>(amount * input.total());
+    const int cn = src.channels();
+    // One word decides corruption against a 32-bit threshold, a second picks
+    // salt or pepper
+    const uint32_t threshold = (uint32_t)std::min(4294967295.0, std::max(0.0, amount) * 4294967296.0);
 
-    for (int i = 0; i < numPixels; i++)
-    {
-        int row = rand() % input.rows;
-        int col = rand() % input.cols;
-
-        if (output.channels() == 1) {
-            output.at<uchar>(row, col) = (rand() % 2) ? 255 : 0;
-        } else {
-            if (rand() % 2)
-                output.at<cv::Vec3b>(row, col) = cv::Vec3b(255,255,255);
-            else
-                output.at<cv::Vec3b>(row, col) = cv::Vec3b(0,0,0);
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; y++)
+        {
+            const T* in = src.ptr<T>(y);
+            T* out = dst.ptr<T>(y);
+            for (int x = 0; x < src.cols; x++)
+            {
+                PhiloxRNG::Block r = PhiloxRNG::generate((uint64_t)y * src.cols + x, seed, SALT_PEPPER_STREAM);
+                if (r[0] >= threshold)
+                {
+                    if (out != in) for (int c = 0; c < cn; c++) out[x * cn + c] = in[x * cn + c];
+                    continue;
+                }
+                T value = (r[1] & 1u) ? white : T(0);
+                for (int c = 0; c < cn; c++) out[x * cn + c] = value;
+            }
         }
+    });
+}
+
+void saltPepper(const cv::Mat& src, cv::Mat& dst, double amount, uint64_t seed)
+{
+    dst.create(src.size(), src.type());
+    switch (src.depth())
+    {
+        case CV_8U:  saltPepper<uchar>(src, dst, amount, seed, 255); break;
+        case CV_16U: saltPepper<uint16_t>(src, dst, amount, seed, 65535); break;
+        case CV_32F: saltPepper<float>(src, dst, amount, seed, 1.0f); break;
+        default: CV_Error(cv::Error::StsUnsupportedFormat, "NoiseGenerator: unsupported depth");
     }
+}
+
+} // namespace
+
+cv::Mat NoiseGenerator::addGaussianNoise(const cv::Mat& input, double stddev, uint64_t seed)
+{
+    cv::Mat output;
+    gaussian(input, output, stddev, seed);
+    return output;
+}
 
+cv::Mat NoiseGenerator::addUniformNoise(const cv::Mat& input, int intensity, uint64_t seed)
+{
+    cv::Mat output;
+    uniform(input, output, intensity, seed);
+    return output;
+}
+
+cv::Mat NoiseGenerator::addZeroMeanUniformNoise(const cv::Mat& input, int intensity, uint64_t seed)
+{
+    cv::Mat output;
+    zeroMeanUniform(input, output, intensity, seed);
+    return output;
+}
+
+cv::Mat NoiseGenerator::addSaltPepperNoise(const cv::Mat& input, double amount, uint64_t seed)
+{
+    cv::Mat output;
+    saltPepper(input, output, amount, seed);
     return output;
-}
\ No newline at end of file
+}
+
+void NoiseGenerator::addGaussianNoiseInPlace(cv::Mat& image, double stddev, uint64_t seed)
+{
+    gaussian(image, image, stddev, seed);
+}
+
+void NoiseGenerator::addUniformNoiseInPlace(cv::Mat& image, int intensity, uint64_t seed)
+{
+    uniform(image, image, intensity, seed);
+}
+
+void NoiseGenerator::addZeroMeanUniformNoiseInPlace(cv::Mat& image, int intensity, uint64_t seed)
+{
+    zeroMeanUniform(image, image, intensity, seed);
+}
+
+void NoiseGenerator::addSaltPepperNoiseInPlace(cv::Mat& image, double amount, uint64_t seed)
+{
+    saltPepper(image, image, amount, seed);
+}
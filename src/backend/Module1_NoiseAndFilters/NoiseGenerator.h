@@ -1,8 +1,24 @@
 #pragma once
 #include<opencv2/opencv.hpp>
+#include <cstdint>
+
+// Noise is drawn from a counter-based RNG keyed by (seed, pixel index), so a given
+// seed reproduces the same image bit for bit, however many threads run the rows.
+// Each call is a single pass: samples are generated per pixel and added with
+// saturation straight into the output, no full-size noise image is allocated.
+// The InPlace variants write back into `image` and allocate nothing.
 class NoiseGenerator
 {public:
-    static cv::Mat addGaussianNoise(const cv::Mat& input,double stddev);
-    static cv::Mat addUniformNoise(const cv::Mat& input, int intensity);
-    static cv::Mat addSaltPepperNoise(const cv::Mat& input, double amount);
-};
\ No newline at end of file
+    static cv::Mat addGaussianNoise(const cv::Mat& input,double stddev, uint64_t seed = 0);
+    // Adds integers in [0, intensity) (brightens on average)
+    static cv::Mat addUniformNoise(const cv::Mat& input, int intensity, uint64_t seed = 0);
+    // Adds values in [-intensity / 2, intensity / 2) (mean brightness unchanged)
+    static cv::Mat addZeroMeanUniformNoise(const cv::Mat& input, int intensity, uint64_t seed = 0);
+    // Each pixel independently becomes salt or pepper with probability `amount`
+    static cv::Mat addSaltPepperNoise(const cv::Mat& input, double amount, uint64_t seed = 0);
+
+    static void addGaussianNoiseInPlace(cv::Mat& image, double stddev, uint64_t seed = 0);
+    static void addUniformNoiseInPlace(cv::Mat& image, int intensity, uint64_t seed = 0);
+    static void addZeroMeanUniformNoiseInPlace(cv::Mat& image, int intensity, uint64_t seed = 0);
+    static void addSaltPepperNoiseInPlace(cv::Mat& image, double amount, uint64_t seed = 0);
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random numbers:
+// as easy as 1, 2, 3", SC'11). Every (counter, key, stream) triple maps to four
+// independent 32-bit words with no state in between, so a pixel's noise can be
+// computed straight from its index: parallel loops produce the same image for a
+// given seed whatever the thread count or scheduling.
+class PhiloxRNG
+{
+public:
+    typedef std::array<uint32_t, 4> Block;
+
+    static Block generate(uint64_t counter, uint64_t key, uint32_t stream = 0)
+    {
+        uint32_t c0 = (uint32_t)counter, c1 = (uint32_t)(counter >> 32), c2 = stream, c3 = 0;
+        uint32_t k0 = (uint32_t)key, k1 = (uint32_t)(key >> 32);
+        for (int round = 0; round < 10; round++)
+        {
+            uint64_t p0 = (uint64_t)M0 * c0;
+            uint64_t p1 = (uint64_t)M1 * c2;
+            c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+            c1 = (uint32_t)p1;
+            c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+            c3 = (uint32_t)p0;
+            k0 += W0;
+            k1 += W1;
+        }
+        return Block{{c0, c1, c2, c3}};
+    }
+
+    // Uniform in [0, 1) from the top 24 bits of a word
+    static float uniform(uint32_t word)
+    {
+        return (word >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // Two independent standard normals from two words (Box-Muller)
+    static void normalPair(uint32_t a, uint32_t b, float& n0, float& n1)
+    {
+        float u1 = ((a >> 8) + 1.0f) * (1.0f / 16777216.0f);  // (0, 1], keeps log finite
+        float u2 = uniform(b);
+        float radius = std::sqrt(-2.0f * std::log(u1));
+        float angle = 6.2831853f * u2;
+        n0 = radius * std::cos(angle);
+        n1 = radius * std::sin(angle);
+    }
+
+private:
+    static const uint32_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+    static const uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+};
@@ -1,20 +1,20 @@
 #include "EdgeDetectors.h"
 #include <cmath>
 
-cv::Mat EdgeDetectors::convolve(const cv::Mat& input, const std::vector<std::vector<int>>& kernel) {
+// Private helper: the convolution loop for one pixel type
+template <typename T>
+static void convolveTyped(const cv::Mat& input, const std::vector<std::vector<int>>& kernel, cv::Mat& output) {
     int kRows = kernel.size();
     int kCols = kernel[0].size();
     int padY = kRows / 2;
     int padX = kCols / 2;
 
-    cv::Mat output = cv::Mat::zeros(input.size(), CV_32F);
-
     for (int y = padY; y < input.rows - padY; ++y) {
         for (int x = padX; x < input.cols - padX; ++x) {
             float sum = 0.0f;
             for (int ky = -padY; ky <= padY; ++ky) {
                 for (int kx = -padX; kx <= padX; ++kx) {
-                    int pixel = input.at<uchar>(y + ky, x + kx);
+                    float pixel = (float)input.at<T>(y + ky, x + kx);
                     int weight = kernel[ky + padY][kx + padX];
                     sum += pixel * weight;
                 }
@@ -22,11 +22,30 @@ cv::Mat EdgeDetectors::convolve(const cv::Mat& input, const std::vector<std::vec
             output.at<float>(y, x) = sum;
         }
     }
+}
+
+cv::Mat EdgeDetectors::convolve(const cv::Mat& input, const std::vector<std::vector<int>>& kernel) {
+    cv::Mat output = cv::Mat::zeros(input.size(), CV_32F);
+
+    switch (input.depth()) {
+        case CV_8U:  convolveTyped<uchar>(input, kernel, output); break;
+        case CV_16U: convolveTyped<uint16_t>(input, kernel, output); break;
+        default: {
+            cv::Mat input32f;
+            input.convertTo(input32f, CV_32F);
+            convolveTyped<float>(input32f, kernel, output);
+        }
+    }
     return output;
 }
 
+// Gradients are shown as 8-bit: 16-bit input is scaled down by 257 (65535 -> 255)
+static double displayScale(const cv::Mat& input) {
+    return input.depth() == CV_16U ? 1.0 / 257.0 : 1.0;
+}
+
 // Private helper to process the 3 outputs for the manual convolution methods
-static std::vector<cv::Mat> processGradients(const cv::Mat& gradX, const cv::Mat& gradY) {
+static std::vector<cv::Mat> processGradients(const cv::Mat& gradX, const cv::Mat& gradY, double scale) {
     cv::Mat magnitude = cv::Mat::zeros(gradX.size(), CV_32F);
     for (int y = 0; y < gradX.rows; ++y) {
         for (int x = 0; x < gradX.cols; ++x) {
@@ -37,9 +56,9 @@ static std::vector<cv::Mat> processGradients(const cv::Mat& gradX, const cv::Mat
     }
 
     cv::Mat dispX, dispY, dispMag;
-    cv::convertScaleAbs(gradX, dispX); 
-    cv::convertScaleAbs(gradY, dispY);
-    cv::convertScaleAbs(magnitude, dispMag);
+    cv::convertScaleAbs(gradX, dispX, scale); 
+    cv::convertScaleAbs(gradY, dispY, scale);
+    cv::convertScaleAbs(magnitude, dispMag, scale);
 
     return {dispX, dispY, dispMag};
 }
@@ -54,7 +73,7 @@ std::vector<cv::Mat> EdgeDetectors::applySobel(const cv::Mat& input) {
     cv::Mat gradX = convolve(gray, sobelX);
     cv::Mat gradY = convolve(gray, sobelY);
 
-    return processGradients(gradX, gradY);
+    return processGradients(gradX, gradY, displayScale(gray));
 }
 
 std::vector<cv::Mat> EdgeDetectors::applyPrewitt(const cv::Mat& input) {
@@ -67,7 +86,7 @@ std::vector<cv::Mat> EdgeDetectors::applyPrewitt(const cv::Mat& input) {
     cv::Mat gradX = convolve(gray, prewittX);
     cv::Mat gradY = convolve(gray, prewittY);
 
-    return processGradients(gradX, gradY);
+    return processGradients(gradX, gradY, displayScale(gray));
 }
 
 std::vector<cv::Mat> EdgeDetectors::applyRoberts(const cv::Mat& input) {
@@ -80,12 +99,14 @@ std::vector<cv::Mat> EdgeDetectors::applyRoberts(const cv::Mat& input) {
     cv::Mat gradX = convolve(gray, robertsX);
     cv::Mat gradY = convolve(gray, robertsY);
 
-    return processGradients(gradX, gradY);
+    return processGradients(gradX, gradY, displayScale(gray));
 }
 
 cv::Mat EdgeDetectors::applyCanny(const cv::Mat& input, double lowerThresh, double upperThresh) {
     cv::Mat gray = input.clone();
     if (gray.channels() == 3) cv::cvtColor(gray, gray, cv::COLOR_BGR2GRAY);
+    // cv::Canny takes 8-bit only; the thresholds are on that scale too
+    if (gray.depth() != CV_8U) gray.convertTo(gray, CV_8U, displayScale(gray));
 
     cv::Mat edges;
     cv::Canny(gray, edges, lowerThresh, upperThresh);
@@ -1,23 +1,67 @@
 #include "EntropyCalculator.h"
+#include "../Module3_HistogramsAndColor/HistogramTools.h"
+#include <algorithm>
 #include <vector>
 #include <cmath>
 
-double EntropyCalculator::calculate(const cv::Mat& input) {
-    cv::Mat gray = input.clone();
-    if (gray.channels() == 3) { cv::cvtColor(gray, gray, cv::COLOR_BGR2GRAY); }
+// Private helper: local entropy for output rows [y0, y1). `padded` carries r
+// reflected pixels on every side, so output (y, x) sees padded rows y..y+2r and
+// columns x..x+2r. The window at the start of each row is itself slid down from
+// the previous row, so only the band's first row is counted in full.
+static void localEntropyBand(const cv::Mat& padded, cv::Mat& dst, int r, int y0, int y1,
+                             const std::vector<double>& nLogN) {
+    const int d = 2 * r + 1;
+    const double N = (double)d * d, logN = std::log2(N);
+
+    int rowStart[256] = {}, hist[256];
+    double sumStart = 0.0;
+    auto bump = [&nLogN](int* h, double& sum, int bin, int delta) {
+        sum += nLogN[h[bin] + delta] - nLogN[h[bin]];
+        h[bin] += delta;
+    };
+
+    for (int py = y0; py < y0 + d; ++py) {
+        const uchar* row = padded.ptr<uchar>(py);
+        for (int c = 0; c < d; ++c) bump(rowStart, sumStart, row[c], 1);
+    }
+
+    for (int y = y0; y < y1; ++y) {
+        if (y > y0) {
+            const uchar* gone = padded.ptr<uchar>(y - 1);
+            const uchar* in = padded.ptr<uchar>(y + 2 * r);
+            for (int c = 0; c < d; ++c) {
+                bump(rowStart, sumStart, gone[c], -1);
+                bump(rowStart, sumStart, in[c], 1);
+            }
+        }
 
-    std::vector<double> pixelCounts(256, 0.0);
-    for (int y = 0; y < gray.rows; ++y) {
-        for (int x = 0; x < gray.cols; ++x) {
-            int pixelValue = gray.at<uchar>(y, x);
-            pixelCounts[pixelValue]++;
+        std::copy(rowStart, rowStart + 256, hist);
+        double sum = sumStart;
+        float* out = dst.ptr<float>(y);
+        for (int x = 0; x < dst.cols; ++x) {
+            if (x > 0) {
+                for (int i = 0; i < d; ++i) {
+                    const uchar* row = padded.ptr<uchar>(y + i);
+                    bump(hist, sum, row[x - 1], -1);
+                    bump(hist, sum, row[x + 2 * r], 1);
+                }
+            }
+            out[x] = (float)std::max(0.0, logN - sum / N);
         }
     }
+}
+
+double EntropyCalculator::calculate(const cv::Mat& input) {
+    cv::Mat gray = input;
+    if (gray.channels() == 3) { cv::cvtColor(gray, gray, cv::COLOR_BGR2GRAY); }
+
+    // 256 bins for 8-bit data, 65536 for 16-bit
+    std::vector<uint32_t> pixelCounts = HistogramTools::channelHistograms(gray);
 
-    double totalPixels = gray.rows * gray.cols;
+    double totalPixels = (double)gray.rows * gray.cols;
     double entropy = 0.0;
 
-    for (int i = 0; i < 256; ++i) {
+    for (size_t i = 0; i < pixelCounts.size(); ++i) {
         if (pixelCounts[i] > 0) {
             double probability = pixelCounts[i] / totalPixels;
             entropy -= probability * std::log2(probability);
@@ -26,16 +70,65 @@ double EntropyCalculator::calculate(const cv::Mat& input) {
     return entropy;
 }
 
+int EntropyCalculator::maxBits(const cv::Mat& input) {
+    return input.depth() == CV_16U ? 16 : 8;
+}
+
+cv::Mat EntropyCalculator::localEntropyMap(const cv::Mat& input, int windowSize, double* elapsedMs) {
+    if (input.empty()) return cv::Mat();
+    int64 start = cv::getTickCount();
+    CV_Assert(windowSize >= 3 && windowSize % 2 == 1);
+    const int r = windowSize / 2;
+
+    cv::Mat gray = input;
+    if (gray.channels() == 3) cv::cvtColor(gray, gray, cv::COLOR_BGR2GRAY);
+    if (gray.channels() == 4) cv::cvtColor(gray, gray, cv::COLOR_BGRA2GRAY);
+    // Same 65535 -> 255 scaling as the edge display and the image panels
+    if (gray.depth() == CV_16U) gray.convertTo(gray, CV_8U, 1.0 / 257.0);
+    CV_Assert(gray.type() == CV_8UC1);
+
+    // Reflection needs r < size; clamp the window on tiny images
+    const int rr = std::min(r, std::max(1, std::min(gray.rows, gray.cols) - 1));
+    cv::Mat padded;
+    cv::copyMakeBorder(gray, padded, rr, rr, rr, rr, cv::BORDER_REFLECT_101);
+
+    const int area = (2 * rr + 1) * (2 * rr + 1);
+    std::vector<double> nLogN(area + 1, 0.0);
+    for (int n = 1; n <= area; ++n) nLogN[n] = n * std::log2((double)n);
+
+    // Bands of at least 2r rows so the full count at the top of each band stays amortised
+    cv::Mat map(gray.size(), CV_32F);
+    const int minBandRows = std::max(32, 2 * rr);
+    const int bands = std::max(1, std::min(gray.rows / minBandRows, cv::getNumThreads() * 4));
+    cv::parallel_for_(cv::Range(0, bands), [&](const cv::Range& range) {
+        for (int band = range.start; band < range.end; ++band) {
+            int y0 = (int)((int64)gray.rows * band / bands);
+            int y1 = (int)((int64)gray.rows * (band + 1) / bands);
+            localEntropyBand(padded, map, rr, y0, y1, nLogN);
+        }
+    });
+
+    if (elapsedMs) *elapsedMs = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+    return map;
+}
+
+cv::Mat EntropyCalculator::renderEntropyMap(const cv::Mat& entropyMap) {
+    if (entropyMap.empty()) return cv::Mat();
+    cv::Mat scaled, colored;
+    entropyMap.convertTo(scaled, CV_8U, 255.0 / 8.0);
+    cv::applyColorMap(scaled, colored, cv::COLORMAP_INFERNO);
+    return colored;
+}
+
 cv::Mat EntropyCalculator::plotHistogram(const cv::Mat& input) {
     cv::Mat gray;
     if (input.channels() == 3) cv::cvtColor(input, gray, cv::COLOR_BGR2GRAY);
     else gray = input.clone();
 
+    // 16-bit data is folded into 256 display bins
     int histSize = 256;
-    float range[] = { 0, 256 };
-    const float* histRange = { range };
-    cv::Mat hist;
-    cv::calcHist(&gray, 1, 0, cv::Mat(), hist, 1, &histSize, &histRange, true, false);
+    cv::Mat hist, cdf;
+    HistogramTools::getHistogramAndCDF(gray, hist, cdf);
 
     int hist_w = 512, hist_h = 400;
     int bin_w = cvRound((double) hist_w / histSize);
@@ -5,9 +5,23 @@
 
 class EntropyCalculator {
 public:
-    // Calculates the raw entropy value of the image
+    // Calculates the raw entropy value of the image (8-bit or 16-bit, in bits)
     static double calculate(const cv::Mat& input);
 
+    // Upper bound of calculate() for the image depth: 8 or 16 bits
+    static int maxBits(const cv::Mat& input);
+
+    // Entropy of the windowSize x windowSize neighbourhood of every pixel (CV_32F,
+    // bits), over 256 gray levels; 16-bit input is scaled down to 8 bits first.
+    // The window histogram slides: each step right removes one column and adds
+    // one, and H = log2(N) - S / N with S = sum n log2 n kept up to date from a
+    // table of n log2 n, so the cost per pixel grows with the window width only.
+    // Row bands run in parallel. Borders are reflected (BORDER_REFLECT_101).
+    static cv::Mat localEntropyMap(const cv::Mat& input, int windowSize, double* elapsedMs = nullptr);
+
+    // Entropy map scaled to 0..8 bits and coloured (inferno) for display
+    static cv::Mat renderEntropyMap(const cv::Mat& entropyMap);
+
     // Creates a beautiful neon histogram graph of the pixel distribution
     static cv::Mat plotHistogram(const cv::Mat& input);
 };
@@ -0,0 +1,165 @@
+#include "QualityMetrics.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+const int SSIM_WINDOW = 7;
+
+cv::Mat toGray(const cv::Mat& img) {
+    if (img.channels() == 3) { cv::Mat g; cv::cvtColor(img, g, cv::COLOR_BGR2GRAY); return g; }
+    if (img.channels() == 4) { cv::Mat g; cv::cvtColor(img, g, cv::COLOR_BGRA2GRAY); return g; }
+    return img;
+}
+
+// Luminance scaled to [0, 1] so the SSIM constants are the same for every depth
+cv::Mat unitGray(const cv::Mat& img) {
+    cv::Mat g;
+    toGray(img).convertTo(g, CV_32F, 1.0 / QualityMetrics::peakFor(img.depth()));
+    return g;
+}
+
+// Squared error over rows [y0, y1) in units of each image's full range, so mixed
+// depths (16-bit vs 8-bit) compare at their common maximum instead of saturating
+double squaredError(const cv::Mat& a, const cv::Mat& b, int y0, int y1) {
+    cv::Range rows(y0, y1);
+    if (a.depth() == b.depth()) {
+        // NORM_L2SQR is a single vectorised pass with wide accumulation
+        double s = 1.0 / QualityMetrics::peakFor(a.depth());
+        return cv::norm(a.rowRange(rows), b.rowRange(rows), cv::NORM_L2SQR) * s * s;
+    }
+    cv::Mat ua, ub;
+    a.rowRange(rows).convertTo(ua, CV_32F, 1.0 / QualityMetrics::peakFor(a.depth()));
+    b.rowRange(rows).convertTo(ub, CV_32F, 1.0 / QualityMetrics::peakFor(b.depth()));
+    return cv::norm(ua, ub, cv::NORM_L2SQR);
+}
+
+// SSIM summed over output rows [y0, y1). px / py are the [0, 1] luminance planes
+// padded by the window radius (BORDER_REFLECT_101). Column sums of the five local
+// statistics slide down the band and a row sum slides along each line, so they
+// are never stored as planes.
+double ssimBand(const cv::Mat& px, const cv::Mat& py, int y0, int y1) {
+    const int r = SSIM_WINDOW / 2, PW = px.cols, W = PW - 2 * r;
+    const double area = SSIM_WINDOW * SSIM_WINDOW;
+    const double C1 = 0.01 * 0.01, C2 = 0.03 * 0.03;
+
+    std::vector<double> col(5 * (size_t)PW, 0.0);
+    auto addRow = [&](int row, double sign) {
+        const float* x = px.ptr<float>(row);
+        const float* y = py.ptr<float>(row);
+        for (int c = 0; c < PW; c++) {
+            double xv = x[c], yv = y[c];
+            double* s = &col[5 * (size_t)c];
+            s[0] += sign * xv;
+            s[1] += sign * yv;
+            s[2] += sign * xv * xv;
+            s[3] += sign * yv * yv;
+            s[4] += sign * xv * yv;
+        }
+    };
+    for (int row = y0; row < y0 + SSIM_WINDOW; row++) addRow(row, 1.0);
+
+    double sum = 0.0;
+    for (int y = y0; y < y1; y++) {
+        if (y > y0) {
+            addRow(y - 1, -1.0);
+            addRow(y + 2 * r, 1.0);
+        }
+
+        double w[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+        for (int c = 0; c < SSIM_WINDOW; c++)
+            for (int k = 0; k < 5; k++) w[k] += col[5 * c + k];
+
+        for (int x = 0; x < W; x++) {
+            if (x > 0) {
+                const double* in = &col[5 * (size_t)(x + 2 * r)];
+                const double* gone = &col[5 * (size_t)(x - 1)];
+                for (int k = 0; k < 5; k++) w[k] += in[k] - gone[k];
+            }
+            double mx = w[0] / area, my = w[1] / area;
+            double vx = w[2] / area - mx * mx, vy = w[3] / area - my * my, cxy = w[4] / area - mx * my;
+            sum += ((2 * mx * my + C1) * (2 * cxy + C2)) /
+                   ((mx * mx + my * my + C1) * (vx + vy + C2));
+        }
+    }
+    return sum;
+}
+
+// MSE (in units of a's full range) and SSIM, either may be null, from one
+// parallel pass over row bands
+void measure(const cv::Mat& a, const cv::Mat& b, double* mse, double* ssim) {
+    CV_Assert(a.size() == b.size() && !a.empty());
+    const int r = SSIM_WINDOW / 2;
+
+    // MSE runs over every channel when the layouts agree, else on luminance
+    bool sameLayout = a.channels() == b.channels();
+    cv::Mat x, y, px, py;
+    if (ssim || !sameLayout) {
+        x = unitGray(a);
+        y = unitGray(b);
+    }
+    if (ssim) {
+        cv::copyMakeBorder(x, px, r, r, r, r, cv::BORDER_REFLECT_101);
+        cv::copyMakeBorder(y, py, r, r, r, r, cv::BORDER_REFLECT_101);
+    }
+    const cv::Mat& ea = sameLayout ? a : x;
+    const cv::Mat& eb = sameLayout ? b : y;
+
+    const int chunks = std::max(1, std::min(a.rows, cv::getNumThreads() * 4));
+    std::vector<double> errPart(chunks, 0.0), ssimPart(chunks, 0.0);
+    cv::parallel_for_(cv::Range(0, chunks), [&](const cv::Range& range) {
+        for (int c = range.start; c < range.end; c++) {
+            int y0 = (int)((int64)a.rows * c / chunks), y1 = (int)((int64)a.rows * (c + 1) / chunks);
+            if (mse)  errPart[c] = squaredError(ea, eb, y0, y1);
+            if (ssim) ssimPart[c] = ssimBand(px, py, y0, y1);
+        }
+    });
+
+    if (mse) {
+        double total = 0.0;
+        for (double e : errPart) total += e;
+        double peak = QualityMetrics::peakFor(a.depth());
+        *mse = total / ((double)ea.total() * ea.channels()) * peak * peak;
+    }
+    if (ssim) {
+        double total = 0.0;
+        for (double s : ssimPart) total += s;
+        *ssim = total / (double)a.total();
+    }
+}
+
+} // namespace
+
+double QualityMetrics::peakFor(int depth) {
+    if (depth == CV_8U)  return 255.0;
+    if (depth == CV_16U) return 65535.0;
+    return 1.0;
+}
+
+double QualityMetrics::mse(const cv::Mat& a, const cv::Mat& b) {
+    double result = 0.0;
+    measure(a, b, &result, nullptr);
+    return result;
+}
+
+double QualityMetrics::psnr(double mse, double peak) {
+    if (mse <= 0.0) return std::numeric_limits<double>::infinity();
+    return 10.0 * std::log10(peak * peak / mse);
+}
+
+double QualityMetrics::ssim(const cv::Mat& a, const cv::Mat& b) {
+    double result = 1.0;
+    measure(a, b, nullptr, &result);
+    return result;
+}
+
+QualityMetrics::Result QualityMetrics::compare(const cv::Mat& a, const cv::Mat& b) {
+    int64 start = cv::getTickCount();
+    Result r;
+    measure(a, b, &r.mse, &r.ssim);
+    r.psnr = psnr(r.mse, peakFor(a.depth()));
+    r.elapsedMs = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+    return r;
+}
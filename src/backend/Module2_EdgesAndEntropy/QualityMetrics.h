@@ -0,0 +1,33 @@
+#ifndef QUALITYMETRICS_H
+#define QUALITYMETRICS_H
+
+#include <opencv2/opencv.hpp>
+
+// Full-reference image quality between two images of the same size.
+//   MSE / PSNR - over every channel, in units of the first image's depth; images
+//                of different depths are compared at their common maximum
+//   SSIM       - on luminance, 7x7 uniform window (Wang et al. with a box window)
+// compare() gets both from one parallel pass over row bands: the squared error of
+// each band, then running window sums of the five SSIM statistics (means, second
+// moments, cross moment), reduced on the fly without any statistics planes.
+class QualityMetrics {
+public:
+    struct Result {
+        double mse = 0.0;
+        double psnr = 0.0;   // +inf for identical images
+        double ssim = 1.0;
+        double elapsedMs = 0.0;
+    };
+
+    // Images with different channel counts are compared on luminance
+    static Result compare(const cv::Mat& a, const cv::Mat& b);
+
+    static double mse(const cv::Mat& a, const cv::Mat& b);
+    static double psnr(double mse, double peak);
+    static double ssim(const cv::Mat& a, const cv::Mat& b);
+
+    // 255 for 8-bit, 65535 for 16-bit, 1 for float data
+    static double peakFor(int depth);
+};
+
+#endif // QUALITYMETRICS_H
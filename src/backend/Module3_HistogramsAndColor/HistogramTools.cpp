@@ -1,10 +1,22 @@
 #include "HistogramTools.h"
+#include <algorithm>
 
 void HistogramTools::getHistogramAndCDF(const cv::Mat& input, cv::Mat& hist, cv::Mat& cdf) {
     int histSize = 256;
-    float range[] = { 0, 256 };
-    const float* histRange = { range };
-    cv::calcHist(&input, 1, 0, cv::Mat(), hist, 1, &histSize, &histRange);
+    if (input.depth() == CV_16U) {
+        std::vector<uint32_t> fine = channelHistograms(input);
+        int top = 65535;
+        while (top > 0 && fine[top] == 0) top--;
+        int shift = 0;
+        while ((top >> shift) > 255) shift++;
+
+        hist = cv::Mat::zeros(histSize, 1, CV_32F);
+        for (int v = 0; v <= top; v++) hist.at<float>(v >> shift) += (float)fine[v];
+    } else {
+        float range[] = { 0, 256 };
+        const float* histRange = { range };
+        cv::calcHist(&input, 1, 0, cv::Mat(), hist, 1, &histSize, &histRange);
+    }
 
     cdf = hist.clone();
     for (int i = 1; i < histSize; i++) {
@@ -13,6 +25,109 @@ void HistogramTools::getHistogramAndCDF(const cv::Mat& input, cv::Mat& hist, cv:
     cv::normalize(cdf, cdf, 0, histSize, cv::NORM_MINMAX);
 }
 
+void HistogramTools::countHistogram8u(const cv::Mat& plane, uint32_t* hist) {
+    CV_Assert(plane.type() == CV_8UC1);
+
+    // Four interleaved sub-histograms: runs of equal pixels would otherwise make
+    // every increment wait on the previous store to the same counter
+    uint32_t sub[4][256] = {};
+    for (int y = 0; y < plane.rows; y++) {
+        const uchar* row = plane.ptr<uchar>(y);
+        int x = 0;
+        for (; x + 4 <= plane.cols; x += 4) {
+            sub[0][row[x]]++;
+            sub[1][row[x + 1]]++;
+            sub[2][row[x + 2]]++;
+            sub[3][row[x + 3]]++;
+        }
+        for (; x < plane.cols; x++) sub[0][row[x]]++;
+    }
+    for (int i = 0; i < 256; i++) hist[i] = sub[0][i] + sub[1][i] + sub[2][i] + sub[3][i];
+}
+
+std::vector<uint32_t> HistogramTools::channelHistograms(const cv::Mat& image) {
+    CV_Assert(image.depth() == CV_8U || image.depth() == CV_16U);
+    const int cn = image.channels();
+    const size_t bins = (image.depth() == CV_8U) ? 256 : 65536;
+    const size_t tableSize = bins * cn;
+
+    // A continuous image (or a 1 x n sample) is split by pixel, not by row
+    const bool flat = image.isContinuous();
+    const int64 units = flat ? (int64)image.total() : image.rows;
+    const int64 unitPixels = flat ? 1 : image.cols;
+
+    // Each private table must count several times its own size to pay for being
+    // zeroed and merged, which caps the chunks on small images and 16-bit tables
+    const int64 pixels = (int64)image.total();
+    const int64 byWork = pixels * cn / (int64)(4 * tableSize);
+    const int chunks = (int)std::max<int64>(1, std::min<int64>({units, (int64)cv::getNumThreads(), byWork}));
+    std::vector<uint32_t> partial(tableSize * chunks, 0);
+
+    auto countRun = [&](uint32_t* h, const uchar* data, int64 n) {
+        if (image.depth() == CV_8U) {
+            const uchar* p = data;
+            for (int64 x = 0; x < n; x++, p += cn)
+                for (int c = 0; c < cn; c++) h[c * bins + p[c]]++;
+        } else {
+            const uint16_t* p = reinterpret_cast<const uint16_t*>(data);
+            for (int64 x = 0; x < n; x++, p += cn)
+                for (int c = 0; c < cn; c++) h[c * bins + p[c]]++;
+        }
+    };
+
+    cv::parallel_for_(cv::Range(0, chunks), [&](const cv::Range& range) {
+        for (int k = range.start; k < range.end; k++) {
+            uint32_t* h = &partial[tableSize * k];
+            int64 u0 = units * k / chunks, u1 = units * (k + 1) / chunks;
+            if (flat) {
+                countRun(h, image.data + u0 * image.elemSize(), u1 - u0);
+            } else {
+                for (int64 y = u0; y < u1; y++) countRun(h, image.ptr((int)y), unitPixels);
+            }
+        }
+    });
+    if (chunks == 1) return partial;
+
+    // Merge by bin ranges in parallel, so 16-bit tables are not summed serially
+    std::vector<uint32_t> hist(tableSize);
+    const int blocks = (int)((tableSize + 4095) / 4096);
+    cv::parallel_for_(cv::Range(0, blocks), [&](const cv::Range& range) {
+        for (int b = range.start; b < range.end; b++) {
+            size_t i0 = (size_t)b * 4096, i1 = std::min(tableSize, i0 + 4096);
+            for (size_t i = i0; i < i1; i++) {
+                uint32_t sum = 0;
+                for (int k = 0; k < chunks; k++) sum += partial[tableSize * k + i];
+                hist[i] = sum;
+            }
+        }
+    });
+    return hist;
+}
+
+void HistogramTools::coarseHistogram16u(const uint32_t* fine, uint32_t* coarse) {
+    for (int b = 0; b < 256; b++) {
+        const uint32_t* block = fine + b * 256;
+        uint32_t sum = 0;
+        for (int i = 0; i < 256; i++) sum += block[i];
+        coarse[b] = sum;
+    }
+}
+
+int HistogramTools::valueAtRank(const uint32_t* hist, int bins, uint64_t rank, const uint32_t* coarse) {
+    uint64_t cum = 0;
+    int v = 0;
+    if (coarse && bins == 65536) {
+        int b = 0;
+        while (b < 255 && cum + coarse[b] <= rank) cum += coarse[b++];
+        v = b * 256;
+    }
+    for (; v < bins; v++) {
+        cum += hist[v];
+        if (cum > rank) return v;
+    }
+    return bins - 1;
+}
+
 cv::Mat HistogramTools::plotHistogram(const cv::Mat& hist, const cv::Mat& cdf, cv::Scalar color) {
     int hist_w = 512, hist_h = 400;
     int bin_w = cvRound((double)hist_w / 256);
@@ -2,13 +2,39 @@
 #define HISTOGRAM_TOOLS_H
 
 #include <opencv2/opencv.hpp>
+#include <cstdint>
 #include <vector>
 
 class HistogramTools {
 public:
-    // Task 4: Calculate Histogram and CDF for a single channel (Gray)
+    // Task 4: Calculate Histogram and CDF for a single channel (Gray). 16-bit
+    // planes are binned adaptively: 256 display bins spanning the smallest
+    // power-of-two range that holds the data (12-bit scans fill the whole plot).
     static void getHistogramAndCDF(const cv::Mat& input, cv::Mat& hist, cv::Mat& cdf);
 
+    // Shared fast path: 256-bin counts of an 8-bit single-channel image (or ROI)
+    // into `hist`, which is overwritten
+    static void countHistogram8u(const cv::Mat& plane, uint32_t* hist);
+
+    // Per-channel counts of an 8-bit (256 bins) or 16-bit (65536 bins) interleaved
+    // image; channel c occupies [c * bins, (c + 1) * bins). Chunks (of pixels for
+    // continuous data, of rows otherwise) count in private tables that are summed
+    // in parallel at the end; the chunk count is capped so each table counts at
+    // least four times its size, so small images and samples stay single-table.
+    static std::vector<uint32_t> channelHistograms(const cv::Mat& image);
+
+    // Two-level view of a 65536-bin table: values sharing a high byte are one
+    // contiguous block of 256 fine bins, `coarse` holds the 256 block sums. Rank
+    // queries then scan 1 KB of coarse sums and a single fine block instead of
+    // the whole 256 KB table.
+    static void coarseHistogram16u(const uint32_t* fine, uint32_t* coarse);
+
+    // Smallest value whose cumulative count exceeds `rank` (0-based); bins - 1 if
+    // the table holds fewer samples. With bins == 65536 and a coarse table the
+    // search is two-level, otherwise a linear walk.
+    static int valueAtRank(const uint32_t* hist, int bins, uint64_t rank,
+                           const uint32_t* coarse = nullptr);
+
     // Task 4 & 8: Helper to visualize the histogram and curve
     static cv::Mat plotHistogram(const cv::Mat& hist, const cv::Mat& cdf, cv::Scalar color);
 };
@@ -0,0 +1,141 @@
+#include "IntegralHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+template <typename T>
+void countCellRow(const cv::Mat& gray, int y0, int y1, int cellSize, int cellsX,
+                  int bins, int shift, uint32_t* out, uint64_t* outSums) {
+    // out[(cx + 1) * bins + b] = counts of bin b over cells [0, cx] of this cell
+    // row, outSums[cx + 1] = sum of the gray levels over the same cells
+    std::vector<uint32_t> acc(bins, 0);
+    uint64_t sum = 0;
+    for (int cx = 0; cx < cellsX; cx++) {
+        int x0 = cx * cellSize, x1 = std::min(gray.cols, x0 + cellSize);
+        for (int y = y0; y < y1; y++) {
+            const T* row = gray.ptr<T>(y);
+            for (int x = x0; x < x1; x++) {
+                acc[row[x] >> shift]++;
+                sum += row[x];
+            }
+        }
+        std::copy(acc.begin(), acc.end(), out + (size_t)(cx + 1) * bins);
+        outSums[cx + 1] = sum;
+    }
+}
+
+} // namespace
+
+void IntegralHistogram::build(const cv::Mat& image, int bins, size_t maxBytes) {
+    CV_Assert(!image.empty() && (image.depth() == CV_8U || image.depth() == CV_16U));
+    cv::Mat gray = image;
+    if (image.channels() == 3) cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+    else if (image.channels() == 4) cv::cvtColor(image, gray, cv::COLOR_BGRA2GRAY);
+    CV_Assert(gray.channels() == 1);
+
+    const int depthBits = (gray.depth() == CV_8U) ? 8 : 16;
+    binCount = 8;
+    while (binCount * 2 <= std::min(bins, 256)) binCount *= 2;
+    imageSize = gray.size();
+
+    // Halve the bins down to 16, then grow the cells, until the table fits
+    auto bytesFor = [&](int b, int cell) {
+        size_t cx = (gray.cols + cell - 1) / cell + 1, cy = (gray.rows + cell - 1) / cell + 1;
+        return cx * cy * (b * sizeof(uint32_t) + sizeof(uint64_t));
+    };
+    cellSize = 1;
+    while (bytesFor(binCount, cellSize) > maxBytes) {
+        if (binCount > 16) binCount /= 2;
+        else cellSize *= 2;
+    }
+    binShift = depthBits - (int)std::log2((double)binCount);
+    cellsX = (gray.cols + cellSize - 1) / cellSize;
+    cellsY = (gray.rows + cellSize - 1) / cellSize;
+
+    counts.assign((size_t)(cellsX + 1) * (cellsY + 1) * binCount, 0);
+    sums.assign((size_t)(cellsX + 1) * (cellsY + 1), 0);
+    const size_t rowStride = (size_t)(cellsX + 1) * binCount;
+
+    // 1. Horizontal prefix counts, independent per cell row
+    cv::parallel_for_(cv::Range(0, cellsY), [&](const cv::Range& range) {
+        for (int cy = range.start; cy < range.end; cy++) {
+            int y0 = cy * cellSize, y1 = std::min(gray.rows, y0 + cellSize);
+            uint32_t* out = &counts[(cy + 1) * rowStride];
+            uint64_t* outSums = &sums[(size_t)(cy + 1) * (cellsX + 1)];
+            if (gray.depth() == CV_8U) countCellRow<uchar>(gray, y0, y1, cellSize, cellsX, binCount, binShift, out, outSums);
+            else                       countCellRow<uint16_t>(gray, y0, y1, cellSize, cellsX, binCount, binShift, out, outSums);
+        }
+    });
+
+    // 2. Vertical prefix sums; column blocks are independent and each row step
+    //    is a contiguous add
+    const int blocks = std::max(1, std::min(cellsX + 1, cv::getNumThreads() * 4));
+    cv::parallel_for_(cv::Range(0, blocks), [&](const cv::Range& range) {
+        for (int k = range.start; k < range.end; k++) {
+            size_t c0 = (size_t)(cellsX + 1) * k / blocks * binCount;
+            size_t c1 = (size_t)(cellsX + 1) * (k + 1) / blocks * binCount;
+            for (int cy = 2; cy <= cellsY; cy++) {
+                const uint32_t* above = &counts[(cy - 1) * rowStride];
+                uint32_t* row = &counts[cy * rowStride];
+                for (size_t i = c0; i < c1; i++) row[i] += above[i];
+            }
+        }
+    });
+    for (int cy = 2; cy <= cellsY; cy++) {
+        const uint64_t* above = &sums[(size_t)(cy - 1) * (cellsX + 1)];
+        uint64_t* row = &sums[(size_t)cy * (cellsX + 1)];
+        for (int i = 0; i <= cellsX; i++) row[i] += above[i];
+    }
+}
+
+cv::Rect IntegralHistogram::snap(const cv::Rect& region) const {
+    cv::Rect r = region & cv::Rect(0, 0, imageSize.width, imageSize.height);
+    int x0 = (int)std::lround((double)r.x / cellSize), x1 = (int)std::lround((double)(r.x + r.width) / cellSize);
+    int y0 = (int)std::lround((double)r.y / cellSize), y1 = (int)std::lround((double)(r.y + r.height) / cellSize);
+    x0 = std::min(x0, cellsX - 1); y0 = std::min(y0, cellsY - 1);
+    x1 = std::max(x1, x0 + 1);     y1 = std::max(y1, y0 + 1);
+
+    cv::Rect cells(x0 * cellSize, y0 * cellSize, (x1 - x0) * cellSize, (y1 - y0) * cellSize);
+    return cells & cv::Rect(0, 0, imageSize.width, imageSize.height);
+}
+
+IntegralHistogram::Stats IntegralHistogram::query(const cv::Rect& region) const {
+    CV_Assert(!empty());
+    Stats s;
+    s.region = snap(region);
+    const int x0 = s.region.x / cellSize, y0 = s.region.y / cellSize;
+    const int x1 = (s.region.x + s.region.width + cellSize - 1) / cellSize;
+    const int y1 = (s.region.y + s.region.height + cellSize - 1) / cellSize;
+
+    const uint32_t *a = at(y0, x0), *b = at(y0, x1), *c = at(y1, x0), *d = at(y1, x1);
+    s.hist.resize(binCount);
+    for (int i = 0; i < binCount; i++) s.hist[i] = d[i] - b[i] - c[i] + a[i];
+    s.count = (uint64_t)s.region.area();
+
+    s.cdf.resize(binCount);
+    uint64_t cum = 0;
+    for (int i = 0; i < binCount; i++) {
+        cum += s.hist[i];
+        s.cdf[i] = (float)((double)cum / s.count);
+        if (s.hist[i] > 0) {
+            double p = (double)s.hist[i] / s.count;
+            s.entropy -= p * std::log2(p);
+        }
+    }
+
+    uint64_t sum = sumAt(y1, x1) - sumAt(y0, x1) - sumAt(y1, x0) + sumAt(y0, x0);
+    s.mean = (double)sum / s.count;
+    return s;
+}
+
+void IntegralHistogram::toPlot(const Stats& stats, cv::Mat& hist, cv::Mat& cdf) {
+    const int bins = (int)stats.hist.size();
+    const int width = 256 / bins;
+    hist.create(256, 1, CV_32F);
+    cdf.create(256, 1, CV_32F);
+    for (int v = 0; v < 256; v++) {
+        hist.at<float>(v) = (float)stats.hist[v / width] / width;
+        cdf.at<float>(v) = stats.cdf[v / width] * 256.0f;
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef INTEGRAL_HISTOGRAM_H
+#define INTEGRAL_HISTOGRAM_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+// Integral histogram of an image's gray levels: entry (y, x) holds the counts of
+// every bin over the rectangle [0, x) x [0, y), so the histogram of any rectangle
+// is four vector lookups, O(bins), whatever its size. Built once per image.
+//
+// Memory is (cellsX + 1) * (cellsY + 1) * (bins * 4 + 8) bytes: the bin counts
+// plus a running sum of gray levels on the same grid. Levels are quantized to a
+// power-of-two bin count, and when that still exceeds the budget the index is
+// kept on a coarser grid of stride x stride pixel cells; queries are then
+// snapped to that grid (see snap()).
+class IntegralHistogram {
+public:
+    struct Stats {
+        cv::Rect region;              // the rectangle actually measured (after snap)
+        uint64_t count = 0;
+        std::vector<uint32_t> hist;   // bins() entries
+        std::vector<float> cdf;       // normalized to 0..1
+        double entropy = 0.0;         // bits, over the quantized bins
+        double mean = 0.0;            // exact, in input gray levels
+    };
+
+    // 8-bit or 16-bit, gray or BGR (converted to gray). bins is rounded down to a
+    // power of two in [8, 256].
+    void build(const cv::Mat& image, int bins = 64, size_t maxBytes = 256u << 20);
+
+    bool empty() const { return counts.empty(); }
+    int bins() const { return binCount; }
+    int stride() const { return cellSize; }
+    cv::Size size() const { return imageSize; }
+
+    // Region clipped to the image and aligned to the cell grid (non-empty)
+    cv::Rect snap(const cv::Rect& region) const;
+
+    Stats query(const cv::Rect& region) const;
+
+    // Stretches quantized stats to the 256-entry float hist / cdf (0..256) that
+    // HistogramTools::plotHistogram draws
+    static void toPlot(const Stats& stats, cv::Mat& hist, cv::Mat& cdf);
+
+private:
+    cv::Size imageSize;
+    int binCount = 0, binShift = 0, cellSize = 1;
+    int cellsX = 0, cellsY = 0;
+    std::vector<uint32_t> counts;   // (cellsY + 1) x (cellsX + 1) x bins
+    std::vector<uint64_t> sums;     // (cellsY + 1) x (cellsX + 1) gray-level sums
+
+    const uint32_t* at(int cy, int cx) const {
+        return &counts[((size_t)cy * (cellsX + 1) + cx) * binCount];
+    }
+    uint64_t sumAt(int cy, int cx) const {
+        return sums[(size_t)cy * (cellsX + 1) + cx];
+    }
+};
+
+#endif // INTEGRAL_HISTOGRAM_H
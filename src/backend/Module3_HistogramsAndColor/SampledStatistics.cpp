@@ -0,0 +1,61 @@
+#include "SampledStatistics.h"
+#include "HistogramTools.h"
+#include "../Module1_NoiseAndFilters/PhiloxRNG.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+int SampledStatistics::strideFor(cv::Size size, uint64_t targetSamples) {
+    if (targetSamples == 0) return 1;
+    double ratio = (double)size.area() / (double)targetSamples;
+    return std::max(1, (int)std::floor(std::sqrt(ratio)));
+}
+
+cv::Mat SampledStatistics::sample(const cv::Mat& image, int stride, uint64_t seed) {
+    CV_Assert(!image.empty() && stride >= 1);
+    if (stride == 1) return (image.isContinuous() ? image : image.clone()).reshape(0, 1);
+
+    const int blocksX = (image.cols + stride - 1) / stride;
+    const int blocksY = (image.rows + stride - 1) / stride;
+    const size_t elemSize = image.elemSize();
+    cv::Mat out(1, blocksX * blocksY, image.type());
+
+    cv::parallel_for_(cv::Range(0, blocksY), [&](const cv::Range& range) {
+        for (int by = range.start; by < range.end; by++) {
+            const int y0 = by * stride, h = std::min(stride, image.rows - y0);
+            uchar* dst = out.ptr() + (size_t)by * blocksX * elemSize;
+            for (int bx = 0; bx < blocksX; bx++, dst += elemSize) {
+                const int x0 = bx * stride, w = std::min(stride, image.cols - x0);
+                PhiloxRNG::Block r = PhiloxRNG::generate((uint64_t)by * blocksX + bx, seed);
+                int y = y0 + (int)(r[0] % (uint32_t)h), x = x0 + (int)(r[1] % (uint32_t)w);
+                std::copy_n(image.ptr(y) + x * elemSize, elemSize, dst);
+            }
+        }
+    });
+    return out;
+}
+
+double SampledStatistics::dkwEpsilon(uint64_t n, double alpha) {
+    if (n == 0) return 1.0;
+    return std::sqrt(std::log(2.0 / alpha) / (2.0 * (double)n));
+}
+
+double SampledStatistics::entropy(const cv::Mat& sampleGray, double* stdError) {
+    CV_Assert(sampleGray.channels() == 1);
+    std::vector<uint32_t> hist = HistogramTools::channelHistograms(sampleGray);
+    const double n = (double)sampleGray.total();
+
+    double h = 0.0, second = 0.0;
+    int occupied = 0;
+    for (uint32_t count : hist) {
+        if (count == 0) continue;
+        double p = count / n, lp = std::log2(p);
+        h -= p * lp;
+        second += p * lp * lp;
+        occupied++;
+    }
+    if (stdError) *stdError = std::sqrt(std::max(0.0, second - h * h) / n);
+
+    // Unseen levels bias the plug-in estimate low by about (m - 1) / (2n) nats
+    return h + (occupied - 1) / (2.0 * n * std::log(2.0));
+}
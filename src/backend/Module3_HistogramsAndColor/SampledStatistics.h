@@ -0,0 +1,33 @@
+#ifndef SAMPLED_STATISTICS_H
+#define SAMPLED_STATISTICS_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+
+// Approximate image statistics from a stratified pixel sample, for previews on
+// images too large to scan interactively. The image is cut into stride x stride
+// blocks and one pixel is drawn per block at a position jittered by a
+// counter-based RNG, so the sample covers the whole frame evenly and is the
+// same for a given seed whatever the thread count.
+//
+// The sample is returned as a 1 x n image of the input type, so the existing
+// full-image routines (HistogramTools, ImageNormalizer, cvtColor) run on it
+// unchanged and only the error bounds below are specific to sampling.
+class SampledStatistics {
+public:
+    // Block side that yields about targetSamples samples (1 = every pixel)
+    static int strideFor(cv::Size size, uint64_t targetSamples);
+
+    static cv::Mat sample(const cv::Mat& image, int stride, uint64_t seed = 0);
+
+    // Dvoretzky-Kiefer-Wolfowitz: sup |F_n - F| <= eps with probability 1 - alpha,
+    // so a sampled q-quantile lies between the true (q - eps) and (q + eps)
+    // quantiles. Derived for i.i.d. draws; stratification only narrows the error.
+    static double dkwEpsilon(uint64_t n, double alpha = 0.05);
+
+    // Entropy (bits) of a single-channel 8-bit or 16-bit sample with the
+    // Miller-Madow bias correction; stdError is the delta-method standard error
+    static double entropy(const cv::Mat& sampleGray, double* stdError = nullptr);
+};
+
+#endif // SAMPLED_STATISTICS_H
@@ -0,0 +1,152 @@
+#include "HistogramMatcher.h"
+#include "LumaShift.h"
+#include "../Module3_HistogramsAndColor/HistogramTools.h"
+#include "../core/EncodeQueue.h"
+#include <opencv2/core/utils/logger.hpp>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <string>
+
+namespace {
+
+std::vector<double> normalized_cdf(const uint32_t* hist, int bins) {
+    std::vector<double> cdf(bins);
+    double total = 0;
+    for (int i = 0; i < bins; i++) total += hist[i];
+    double sum = 0;
+    for (int i = 0; i < bins; i++) {
+        sum += hist[i];
+        cdf[i] = total > 0 ? sum / total : 1.0;
+    }
+    return cdf;
+}
+
+cv::Mat to_gray(const cv::Mat& image) {
+    if (image.channels() == 1) return image;
+    cv::Mat gray;
+    cv::cvtColor(image, gray, image.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+    return gray;
+}
+
+// "<stem>_<ext>_matched.png" for each path, keeping the source extension so
+// a.jpg and a.tif stay apart; names still equal (same file name in two input
+// folders) get a _2, _3, ... suffix
+std::vector<std::string> output_names(const std::vector<std::string>& paths) {
+    std::vector<std::string> names;
+    std::map<std::string, int> seen;
+    for (const std::string& path : paths) {
+        size_t slash = path.find_last_of("/\\");
+        std::string name = (slash == std::string::npos) ? path : path.substr(slash + 1);
+        size_t dot = name.find_last_of('.');
+        if (dot != std::string::npos && dot != 0) name[dot] = '_';
+
+        int count = ++seen[name];
+        names.push_back(name + (count > 1 ? "_" + std::to_string(count) : std::string()) + "_matched.png");
+    }
+    return names;
+}
+
+} // namespace
+
+void HistogramMatcher::set_reference(const cv::Mat& reference) {
+    CV_Assert(reference.depth() == CV_8U || reference.depth() == CV_16U);
+    CV_Assert(reference.channels() == 1 || reference.channels() >= 3);
+    depth_ = reference.depth();
+    channels_ = std::min(reference.channels(), 3);
+    const int bins = depth_ == CV_8U ? 256 : 65536;
+
+    std::vector<uint32_t> hist = HistogramTools::channelHistograms(reference);
+    channel_cdfs_.clear();
+    for (int c = 0; c < channels_; c++)
+        channel_cdfs_.push_back(normalized_cdf(&hist[(size_t)c * bins], bins));
+
+    // BGR2GRAY uses the same fixed-point weights as LumaShift, so this is the
+    // distribution the luma path matches against
+    if (channels_ == 1) {
+        gray_cdf_ = channel_cdfs_[0];
+    } else {
+        std::vector<uint32_t> grayHist = HistogramTools::channelHistograms(to_gray(reference));
+        gray_cdf_ = normalized_cdf(grayHist.data(), bins);
+    }
+}
+
+void HistogramMatcher::inverse_cdf(const uint32_t* hist, const std::vector<double>& ref_cdf, int* table) {
+    // Both CDFs are monotone, so one forward walk over the reference levels
+    // serves every source level
+    const int bins = (int)ref_cdf.size();
+    std::vector<double> src_cdf = normalized_cdf(hist, bins);
+    int r = 0;
+    for (int v = 0; v < bins; v++) {
+        while (r < bins - 1 && ref_cdf[r] < src_cdf[v]) r++;
+        table[v] = r;
+    }
+}
+
+void HistogramMatcher::append_matching(PointOpChain& chain, const cv::Mat& image) const {
+    CV_Assert(has_reference());
+    CV_Assert(image.depth() == depth_ && chain.depth() == depth_);
+    const int cn = image.channels();
+    const int bins = chain.max_value() + 1;
+
+    std::vector<uint32_t> hist = HistogramTools::channelHistograms(image);
+    cv::Mat table(1, bins, CV_32SC(cn));
+    int* t = table.ptr<int>(0);
+    std::vector<int> mapping(bins);
+    for (int c = 0; c < cn; c++) {
+        const std::vector<double>* ref;
+        if (c >= 3)                          ref = nullptr;           // alpha stays as is
+        else if (cn == 1 || channels_ == 1)  ref = (cn == 1) ? &gray_cdf_ : &channel_cdfs_[0];
+        else                                 ref = &channel_cdfs_[c];
+
+        if (ref) inverse_cdf(&hist[(size_t)c * bins], *ref, mapping.data());
+        for (int v = 0; v < bins; v++) t[v * cn + c] = ref ? mapping[v] : v;
+    }
+    chain.append_table(table);
+}
+
+cv::Mat HistogramMatcher::match(const cv::Mat& image, Mode mode) const {
+    CV_Assert(has_reference() && image.depth() == depth_);
+
+    if (mode == LUMA && image.channels() >= 3) {
+        const int bins = (int)gray_cdf_.size();
+        std::vector<uint32_t> hist(bins);
+        LumaShift::luma_histogram(image, hist.data());
+        std::vector<int> lut(bins);
+        inverse_cdf(hist.data(), gray_cdf_, lut.data());
+        return LumaShift::apply(image, [&lut](int, int, int Y) { return lut[Y]; });
+    }
+
+    PointOpChain chain(depth_);
+    append_matching(chain, image);
+    return chain.apply(image);
+}
+
+int HistogramMatcher::match_files(const std::vector<std::string>& paths, const std::string& output_dir,
+                                  Mode mode, double* elapsed_ms, std::atomic<int>* done) const {
+    int64 start = cv::getTickCount();
+    CV_Assert(has_reference());
+    const std::vector<std::string> names = output_names(paths);
+
+    // One image per worker; the per-image passes then run serially on it
+    EncodeQueue queue;
+    std::atomic<int> skipped{0};
+    cv::parallel_for_(cv::Range(0, (int)paths.size()), [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; i++) {
+            cv::Mat image = cv::imread(paths[i], cv::IMREAD_ANYDEPTH | cv::IMREAD_ANYCOLOR);
+            if (image.empty() || image.depth() != depth_ || image.channels() == 2) {
+                skipped++;
+                if (done) (*done)++;
+                continue;
+            }
+            queue.push(output_dir + "/" + names[i], match(image, mode));
+            if (done) (*done)++;
+        }
+    });
+    queue.finish();
+
+    if (skipped > 0)
+        CV_LOG_WARNING(NULL, "HistogramMatcher: skipped " << skipped.load() << " unreadable or mismatched files");
+    if (elapsed_ms) *elapsed_ms = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+    return queue.written();
+}
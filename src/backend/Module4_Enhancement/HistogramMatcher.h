@@ -0,0 +1,48 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "PointOpChain.h"
+
+// Histogram specification: remaps an image so its histogram follows a reference
+// image's. The reference CDFs are computed once in set_reference(); each image then
+// costs one histogram pass, an O(bins) inverse-CDF walk to build the LUT and one
+// LUT pass, so a single matcher can be reused across a whole batch.
+class HistogramMatcher {
+public:
+    enum Mode {
+        LUMA,         // match Y only and shift B, G, R together (keeps hue)
+        PER_CHANNEL   // match every channel on its own
+    };
+
+    // 8-bit or 16-bit, gray or BGR(A); alpha is ignored
+    void set_reference(const cv::Mat& reference);
+    bool has_reference() const { return !gray_cdf_.empty(); }
+    int reference_depth() const { return depth_; }
+
+    // Append the per-channel matching of `image` to a tone chain. A gray reference
+    // is used for every channel, a colour reference against a gray image uses its luma.
+    void append_matching(PointOpChain& chain, const cv::Mat& image) const;
+
+    // Matched copy of `image` (same depth as the reference). LUMA needs colour;
+    // gray images fall back to PER_CHANNEL.
+    cv::Mat match(const cv::Mat& image, Mode mode = LUMA) const;
+
+    // Reads every path, matches it and writes <output_dir>/<stem>_<ext>_matched.png
+    // through an EncodeQueue (repeated names get a _2, _3, ... suffix). Files that
+    // fail to load or have another depth than the reference are skipped. `done`
+    // (if given) counts processed files and may be polled from another thread.
+    // Returns the number of images written.
+    int match_files(const std::vector<std::string>& paths, const std::string& output_dir,
+                    Mode mode = LUMA, double* elapsed_ms = nullptr, std::atomic<int>* done = nullptr) const;
+
+private:
+    int depth_ = CV_8U;
+    int channels_ = 0;
+    std::vector<std::vector<double>> channel_cdfs_;  // B, G, R (or the single gray channel)
+    std::vector<double> gray_cdf_;                   // luma of a colour reference
+
+    // Smallest reference level whose CDF reaches each source level's CDF
+    static void inverse_cdf(const uint32_t* hist, const std::vector<double>& ref_cdf, int* table);
+};
@@ -1,5 +1,109 @@
 #include "ImageEqualizer.h"
+#include "LumaShift.h"
+#include "../Module3_HistogramsAndColor/HistogramTools.h"
 #include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// Global equalization LUT from an integer histogram of 256 (8-bit) or 65536
+// (16-bit) bins, same mapping as equalize_grayScale; false for a single-valued image
+bool equalization_lut(const uint32_t* hist, int bins, int* lut) {
+    uint64_t cdfMin = 0, total = 0;
+    for (int i = 0; i < bins; i++) total += hist[i];
+    for (int i = 0; i < bins; i++) if (hist[i] > 0) { cdfMin = hist[i]; break; }
+    if (total == cdfMin) return false;
+
+    const double scale = (bins - 1.0) / (double)(total - cdfMin);
+    uint64_t cdf = 0;
+    for (int i = 0; i < bins; i++) {
+        cdf += hist[i];
+        lut[i] = (cdf == 0) ? 0 : cvRound((cdf - cdfMin) * scale);
+    }
+    return true;
+}
+
+// CLAHE on one 8-bit plane
+cv::Mat clahe_plane(const cv::Mat& src, double clip_limit, cv::Size grid) {
+    const int tilesX = std::max(1, std::min(grid.width, src.cols));
+    const int tilesY = std::max(1, std::min(grid.height, src.rows));
+
+    // Pad to a whole number of tiles so every tile has the same area
+    cv::Mat padded = src;
+    if (src.cols % tilesX || src.rows % tilesY)
+        cv::copyMakeBorder(src, padded, 0, (tilesY - src.rows % tilesY) % tilesY,
+                           0, (tilesX - src.cols % tilesX) % tilesX, cv::BORDER_REFLECT_101);
+    const int tileW = padded.cols / tilesX, tileH = padded.rows / tilesY;
+    const int tileArea = tileW * tileH;
+    const int clip = std::max(1, (int)(clip_limit * tileArea / 256));
+
+    // 1. Per-tile clipped histograms -> LUTs, in parallel
+    std::vector<uchar> luts((size_t)tilesX * tilesY * 256);
+    cv::parallel_for_(cv::Range(0, tilesX * tilesY), [&](const cv::Range& range) {
+        uint32_t hist[256];
+        for (int t = range.start; t < range.end; t++) {
+            int tx = t % tilesX, ty = t / tilesX;
+            HistogramTools::countHistogram8u(padded(cv::Rect(tx * tileW, ty * tileH, tileW, tileH)), hist);
+
+            // Clip and hand the excess back evenly, the remainder spread by stride
+            int excess = 0;
+            for (int i = 0; i < 256; i++)
+                if ((int)hist[i] > clip) { excess += hist[i] - clip; hist[i] = clip; }
+            int bonus = excess / 256, residual = excess - bonus * 256;
+            for (int i = 0; i < 256; i++) hist[i] += bonus;
+            if (residual > 0) {
+                int step = std::max(1, 256 / residual);
+                for (int i = 0; i < 256 && residual > 0; i += step, residual--) hist[i]++;
+            }
+
+            uchar* lut = &luts[(size_t)t * 256];
+            const float scale = 255.0f / tileArea;
+            uint32_t sum = 0;
+            for (int i = 0; i < 256; i++) {
+                sum += hist[i];
+                lut[i] = cv::saturate_cast<uchar>(sum * scale);
+            }
+        }
+    });
+
+    // 2. Bilinear blend of the four surrounding tile LUTs. Column tile offsets and
+    //    weights are tabulated once so the row loop is branch-free.
+    std::vector<int> xLeft(src.cols), xRight(src.cols);
+    std::vector<float> xWeight(src.cols);
+    for (int x = 0; x < src.cols; x++) {
+        float txf = (x + 0.5f) / tileW - 0.5f;
+        int tx1 = (int)std::floor(txf);
+        xWeight[x] = txf - tx1;
+        xLeft[x] = std::max(tx1, 0) * 256;
+        xRight[x] = std::min(tx1 + 1, tilesX - 1) * 256;
+    }
+
+    cv::Mat dst(src.size(), CV_8UC1);
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; y++) {
+            float tyf = (y + 0.5f) / tileH - 0.5f;
+            int ty1 = (int)std::floor(tyf);
+            float ya = tyf - ty1;
+            const uchar* top = &luts[(size_t)std::max(ty1, 0) * tilesX * 256];
+            const uchar* bottom = &luts[(size_t)std::min(ty1 + 1, tilesY - 1) * tilesX * 256];
+
+            const uchar* in = src.ptr<uchar>(y);
+            uchar* out = dst.ptr<uchar>(y);
+            for (int x = 0; x < src.cols; x++) {
+                int v = in[x];
+                float xa = xWeight[x];
+                float t = top[xLeft[x] + v] + (top[xRight[x] + v] - top[xLeft[x] + v]) * xa;
+                float b = bottom[xLeft[x] + v] + (bottom[xRight[x] + v] - bottom[xLeft[x] + v]) * xa;
+                out[x] = cv::saturate_cast<uchar>(t + (b - t) * ya);
+            }
+        }
+    });
+    return dst;
+}
+
+} // namespace
 
 // Compute grayscale histogram
 cv::Mat ImageEqualizer::grayScale_histogram(const cv::Mat& image, int min_range, int max_range) {
@@ -98,67 +202,58 @@ cv::Mat ImageEqualizer::get_cdf(const cv::Mat& image, int min_range, int max_ran
 }
 
 // Equalize grayscale image
-cv::Mat ImageEqualizer::equalize_grayScale(const cv::Mat& image) {
-    cv::Mat hist = grayScale_histogram(image);
-    cv::Mat cdf(256, 1, CV_32F);
-
-    float cumsum = 0;
-    for (int i = 0; i < 256; i++) {
-        cumsum += hist.at<float>(i);
-        cdf.at<float>(i) = cumsum;
+void ImageEqualizer::append_equalization(PointOpChain& chain, const cv::Mat& image) {
+    CV_Assert(image.channels() == 1 && image.depth() == chain.depth());
+    const int bins = chain.max_value() + 1;
+    std::vector<uint32_t> hist;
+    if (image.depth() == CV_8U) {
+        hist.resize(256);
+        HistogramTools::countHistogram8u(image, hist.data());
+    } else {
+        hist = HistogramTools::channelHistograms(image);
     }
 
-    // Mask zeros and normalize to 0-255
-    float cdfMin = 0;
-    for (int i = 0; i < 256; i++) {
-        if (cdf.at<float>(i) > 0) {
-            cdfMin = cdf.at<float>(i);
-            break;
-        }
-    }
-    float cdfMax = cdf.at<float>(255);
-    if (cdfMax == cdfMin)
-    return image.clone();
-
-    cv::Mat lut(1, 256, CV_8U);
-    for (int i = 0; i < 256; i++) {
-        float val = cdf.at<float>(i);
-        if (val == 0)
-            lut.at<uchar>(i) = 0;
-        else
-            lut.at<uchar>(i) = cv::saturate_cast<uchar>((val - cdfMin) * 255.0f / (cdfMax - cdfMin));
-    }
+    // A single-valued image has nothing to stretch: leave the chain as it is
+    cv::Mat lut(1, bins, CV_32S);
+    if (equalization_lut(hist.data(), bins, lut.ptr<int>()))
+        chain.append_table(lut);
+}
 
-    cv::Mat equalized;
-    cv::LUT(image, lut, equalized);
-    return equalized;
+cv::Mat ImageEqualizer::equalize_grayScale(const cv::Mat& image) {
+    PointOpChain chain(image.depth());
+    append_equalization(chain, image);
+    return chain.apply(image);
 }
 
 cv::Mat ImageEqualizer::equalize_rgb(const cv::Mat& image) {
+    // Equalizes luminance (Y of YCrCb) only, in two passes over the BGR data and
+    // without building the YCrCb image: histogram of Y, then BGR + (lut[Y] - Y).
+    // Matches the cvtColor round trip to within rounding.
+    const int bins = (image.depth() == CV_8U) ? 256 : 65536;
+    std::vector<uint32_t> hist(bins);
+    LumaShift::luma_histogram(image, hist.data());
 
-    // Convert the image to YCrCb color space
-    cv::Mat ycrcb;
-    cv::cvtColor(image, ycrcb, cv::COLOR_BGR2YCrCb);
-
-    // Split the channels
-    std::vector<cv::Mat> channels;
-    cv::split(ycrcb, channels);
-
-    // Apply equalization only on the luminance channel (Y)
-    channels[0] = equalize_grayScale(channels[0]);
-
-    // Merge the channels back
-    cv::merge(channels, ycrcb);
+    std::vector<int> lut(bins);
+    if (!equalization_lut(hist.data(), bins, lut.data()))
+        return image.clone();
 
-    // Convert back to BGR color space
-    cv::Mat result;
-    cv::cvtColor(ycrcb, result, cv::COLOR_YCrCb2BGR);
-
-    return result;
+    return LumaShift::apply(image, [&lut](int, int, int Y) { return lut[Y]; });
 }
     
  
 
+cv::Mat ImageEqualizer::equalize_clahe(const cv::Mat& image, double clip_limit, cv::Size tile_grid) {
+    CV_Assert(image.depth() == CV_8U);
+    if (image.channels() == 1)
+        return clahe_plane(image, clip_limit, tile_grid);
+
+    // Luma only, chroma untouched: the tiles need Y as a plane, the result is
+    // applied back to BGR as a luma shift
+    cv::Mat luma = LumaShift::luma_plane(image);
+    cv::Mat equalized = clahe_plane(luma, clip_limit, tile_grid);
+    return LumaShift::apply(image, [&equalized](int y, int x, int) { return (int)equalized.ptr<uchar>(y)[x]; });
+}
+
 // Equalize image (grayscale or RGB)
 cv::Mat ImageEqualizer::equalize_image(const cv::Mat& image) {
     if (image.channels() == 1)
@@ -1,5 +1,6 @@
 #pragma once
 #include <opencv2/opencv.hpp>
+#include "PointOpChain.h"
 
 class ImageEqualizer {
 public:
@@ -25,12 +26,23 @@ public:
     // Get CDF (grayscale or RGB)
     cv::Mat get_cdf(const cv::Mat& image, int min_range = 0, int max_range = 256);
 
+    // Append the global equalization mapping of an 8-bit or 16-bit gray image to
+    // a tone chain (of the same depth), so it can be fused with other point ops
+    // into one LUT pass; 16-bit data uses the full 65536-level CDF
+    void append_equalization(PointOpChain& chain, const cv::Mat& image);
+
     // Equalize grayscale image
     cv::Mat equalize_grayScale(const cv::Mat& image);
 
     // Equalize RGB image
     cv::Mat equalize_rgb(const cv::Mat& image);
 
+    // Contrast-limited adaptive equalization: per-tile clipped-histogram LUTs,
+    // bilinearly blended between tile centres. Colour images are equalized on luma.
+    // clip_limit is relative to a flat histogram (1 = no contrast gain). 8-bit only.
+    cv::Mat equalize_clahe(const cv::Mat& image, double clip_limit = 2.0,
+                           cv::Size tile_grid = cv::Size(8, 8));
+
     // Equalize image (grayscale or RGB)
     cv::Mat equalize_image(const cv::Mat& image);
 };
@@ -1,5 +1,56 @@
 #include "ImageNormalizer.h"
+#include "../Module3_HistogramsAndColor/HistogramTools.h"
 #include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+
+// Min/max per channel of interleaved rows [y0, y1). Each run of contiguous data
+// is viewed as a single-channel matrix 64 * cn elements wide, so column j always
+// holds channel j % cn; cv::reduce then takes column-wise min and max with
+// OpenCV's vectorised kernels, a cache-sized slab at a time so the second
+// reduction reads from cache. Only the leftover tail is scanned element-wise.
+template <typename T>
+void min_max_rows(const cv::Mat& image, int y0, int y1, int* lo, int* hi) {
+    const int cn = image.channels();
+    const int width = 64 * cn;
+    const int slabRows = 256;
+
+    auto scan = [&](const T* data, size_t n) {
+        size_t blocks = n / width;
+        for (size_t b = 0; b < blocks; b += slabRows) {
+            int rows = (int)std::min<size_t>(slabRows, blocks - b);
+            cv::Mat slab(rows, width, cv::DataType<T>::type, (void*)(data + b * width));
+            cv::Mat mn, mx;
+            cv::reduce(slab, mn, 0, cv::REDUCE_MIN);
+            cv::reduce(slab, mx, 0, cv::REDUCE_MAX);
+            const T* a = mn.ptr<T>();
+            const T* z = mx.ptr<T>();
+            for (int j = 0; j < width; j++) {
+                lo[j % cn] = std::min(lo[j % cn], (int)a[j]);
+                hi[j % cn] = std::max(hi[j % cn], (int)z[j]);
+            }
+        }
+        // Runs start on a pixel boundary, so element i is channel i % cn
+        for (size_t i = blocks * width; i < n; i++) {
+            int c = (int)(i % cn);
+            lo[c] = std::min(lo[c], (int)data[i]);
+            hi[c] = std::max(hi[c], (int)data[i]);
+        }
+    };
+
+    const size_t rowLen = (size_t)image.cols * cn;
+    if (image.isContinuous()) {
+        scan(image.ptr<T>(y0), (size_t)(y1 - y0) * rowLen);
+    } else {
+        for (int y = y0; y < y1; y++) scan(image.ptr<T>(y), rowLen);
+    }
+}
+
+} // namespace
 
 // Normalize grayscale image (returns float 0-1)
 cv::Mat ImageNormalizer::normalize_grayscale(const cv::Mat& image) {
@@ -42,8 +93,92 @@ cv::Mat ImageNormalizer::normalize_rgb(const cv::Mat& image) {
     return normalized;
 }
 
+// Per-channel min/max over interleaved data; row chunks reduce privately
+void ImageNormalizer::channel_min_max(const cv::Mat& image, std::vector<int>& mins, std::vector<int>& maxs) {
+    CV_Assert(image.depth() == CV_8U || image.depth() == CV_16U);
+    const int cn = image.channels();
+    const int chunks = std::max(1, std::min(image.rows, cv::getNumThreads() * 2));
+    std::vector<int> lo((size_t)chunks * cn, INT_MAX), hi((size_t)chunks * cn, INT_MIN);
+
+    cv::parallel_for_(cv::Range(0, chunks), [&](const cv::Range& range) {
+        for (int k = range.start; k < range.end; k++) {
+            int y0 = (int)((int64)image.rows * k / chunks), y1 = (int)((int64)image.rows * (k + 1) / chunks);
+            if (image.depth() == CV_8U) min_max_rows<uchar>(image, y0, y1, &lo[k * cn], &hi[k * cn]);
+            else                        min_max_rows<uint16_t>(image, y0, y1, &lo[k * cn], &hi[k * cn]);
+        }
+    });
+
+    mins.assign(cn, INT_MAX);
+    maxs.assign(cn, INT_MIN);
+    for (int k = 0; k < chunks; k++)
+        for (int c = 0; c < cn; c++) {
+            mins[c] = std::min(mins[c], lo[k * cn + c]);
+            maxs[c] = std::max(maxs[c], hi[k * cn + c]);
+        }
+}
+
+void ImageNormalizer::append_normalization(PointOpChain& chain, const cv::Mat& image) {
+    std::vector<int> mins, maxs;
+    channel_min_max(image, mins, maxs);
+    const double full = chain.max_value();
+
+    // Flat channels map to 0, as in the float path
+    chain.append_per_channel(image.channels(), [&](int c, int v) {
+        int range = maxs[c] - mins[c];
+        return range == 0 ? 0.0 : (v - mins[c]) * full / range;
+    });
+}
+
+void ImageNormalizer::channel_percentiles(const cv::Mat& image, double low, double high,
+                                          std::vector<int>& lows, std::vector<int>& highs) {
+    const int cn = image.channels();
+    const int bins = (image.depth() == CV_8U) ? 256 : 65536;
+    std::vector<uint32_t> hist = HistogramTools::channelHistograms(image);
+
+    // low: first value with cum > low * N; high: first value with cum >= high * N
+    const double total = (double)image.total();
+    const uint64_t lowRank = (uint64_t)std::floor(low * total);
+    const uint64_t highRank = (uint64_t)std::max(0.0, std::ceil(high * total) - 1.0);
+    lows.assign(cn, 0);
+    highs.assign(cn, bins - 1);
+    uint32_t coarse[256];
+    for (int c = 0; c < cn; c++) {
+        const uint32_t* h = &hist[(size_t)c * bins];
+        if (bins == 65536) HistogramTools::coarseHistogram16u(h, coarse);
+        lows[c] = HistogramTools::valueAtRank(h, bins, lowRank, bins == 65536 ? coarse : nullptr);
+        highs[c] = HistogramTools::valueAtRank(h, bins, highRank, bins == 65536 ? coarse : nullptr);
+    }
+}
+
+void ImageNormalizer::append_percentile_normalization(PointOpChain& chain, const cv::Mat& image,
+                                                      double low_pct, double high_pct) {
+    std::vector<int> lows, highs;
+    channel_percentiles(image, low_pct / 100.0, high_pct / 100.0, lows, highs);
+    const double full = chain.max_value();
+
+    chain.append_per_channel(image.channels(), [&](int c, int v) {
+        int range = highs[c] - lows[c];
+        return range <= 0 ? (double)v : (v - lows[c]) * full / range;
+    });
+}
+
+cv::Mat ImageNormalizer::normalize_percentile(const cv::Mat& image, double low_pct, double high_pct) {
+    PointOpChain chain(image.depth());
+    append_percentile_normalization(chain, image, low_pct, high_pct);
+    return chain.apply(image);
+}
+
 // Normalize image (grayscale or RGB)
 cv::Mat ImageNormalizer::normalize_image(const cv::Mat& image) {
+    if (image.depth() != CV_8U && image.depth() != CV_16U)
+        return normalize_image_float(image);
+
+    PointOpChain chain(image.depth());
+    append_normalization(chain, image);
+    return chain.apply(image);
+}
+
+cv::Mat ImageNormalizer::normalize_image_float(const cv::Mat& image) {
     if (image.channels() == 1)
         return normalize_grayscale(image);
     else if (image.channels() == 3)
@@ -1,5 +1,7 @@
 #pragma once
 #include <opencv2/opencv.hpp>
+#include <vector>
+#include "PointOpChain.h"
 
 class ImageNormalizer {
 public:
@@ -9,6 +11,29 @@ public:
     // Normalize RGB image (returns float 0-1 per channel)
     cv::Mat normalize_rgb(const cv::Mat& image);
 
-    // Normalize image (grayscale or RGB)
+    // Per-channel min/max of 8-bit or 16-bit interleaved data in one parallel pass
+    void channel_min_max(const cv::Mat& image, std::vector<int>& mins, std::vector<int>& maxs);
+
+    // Append the per-channel min/max stretch of `image` to a tone chain
+    void append_normalization(PointOpChain& chain, const cv::Mat& image);
+
+    // Per-channel values at fractions low/high (0-1) of the CDF, read off the
+    // channel histograms in O(bins) rather than by sorting pixels
+    void channel_percentiles(const cv::Mat& image, double low, double high,
+                             std::vector<int>& lows, std::vector<int>& highs);
+
+    // Stretch [p_low, p_high] percentiles to the full range, clipping outside;
+    // channels whose two percentiles coincide are left unchanged
+    void append_percentile_normalization(PointOpChain& chain, const cv::Mat& image,
+                                         double low_pct, double high_pct);
+
+    // Robust normalization, e.g. 1% / 99% ignores isolated hot or dead pixels
+    cv::Mat normalize_percentile(const cv::Mat& image, double low_pct = 1.0, double high_pct = 99.0);
+
+    // Normalize image (grayscale or RGB): per-channel stretch to the full range of
+    // the input depth, written through one LUT pass (8-bit in, 8-bit out)
     cv::Mat normalize_image(const cv::Mat& image);
+
+    // Opt-in float output (0-1 per channel), the previous behaviour
+    cv::Mat normalize_image_float(const cv::Mat& image);
 };
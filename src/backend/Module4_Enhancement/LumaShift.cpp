@@ -0,0 +1,57 @@
+#include "LumaShift.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+template <typename T>
+void count_luma_rows(const cv::Mat& bgr, int y0, int y1, uint32_t* h) {
+    const int cn = bgr.channels();
+    for (int y = y0; y < y1; y++) {
+        const T* p = bgr.ptr<T>(y);
+        for (int x = 0; x < bgr.cols; x++, p += cn) h[LumaShift::luma_of(p)]++;
+    }
+}
+
+template <typename T>
+void luma_rows(const cv::Mat& bgr, cv::Mat& luma, int y0, int y1) {
+    const int cn = bgr.channels();
+    for (int y = y0; y < y1; y++) {
+        const T* p = bgr.ptr<T>(y);
+        T* out = luma.ptr<T>(y);
+        for (int x = 0; x < bgr.cols; x++, p += cn) out[x] = (T)LumaShift::luma_of(p);
+    }
+}
+
+} // namespace
+
+// Row chunks count privately and are summed at the end
+void LumaShift::luma_histogram(const cv::Mat& bgr, uint32_t* hist) {
+    CV_Assert((bgr.depth() == CV_8U || bgr.depth() == CV_16U) && bgr.channels() >= 3);
+    const size_t bins = (bgr.depth() == CV_8U) ? 256 : 65536;
+    const int chunks = std::max(1, std::min(bgr.rows, cv::getNumThreads() * 2));
+    std::vector<uint32_t> partial((size_t)chunks * bins, 0);
+
+    cv::parallel_for_(cv::Range(0, chunks), [&](const cv::Range& range) {
+        for (int c = range.start; c < range.end; c++) {
+            uint32_t* h = &partial[(size_t)c * bins];
+            int y0 = (int)((int64)bgr.rows * c / chunks), y1 = (int)((int64)bgr.rows * (c + 1) / chunks);
+            if (bgr.depth() == CV_8U) count_luma_rows<uchar>(bgr, y0, y1, h);
+            else                      count_luma_rows<uint16_t>(bgr, y0, y1, h);
+        }
+    });
+
+    std::fill(hist, hist + bins, 0u);
+    for (int c = 0; c < chunks; c++)
+        for (size_t i = 0; i < bins; i++) hist[i] += partial[(size_t)c * bins + i];
+}
+
+cv::Mat LumaShift::luma_plane(const cv::Mat& bgr) {
+    CV_Assert((bgr.depth() == CV_8U || bgr.depth() == CV_16U) && bgr.channels() >= 3);
+    cv::Mat luma(bgr.size(), CV_MAKETYPE(bgr.depth(), 1));
+    cv::parallel_for_(cv::Range(0, bgr.rows), [&](const cv::Range& range) {
+        if (bgr.depth() == CV_8U) luma_rows<uchar>(bgr, luma, range.start, range.end);
+        else                      luma_rows<uint16_t>(bgr, luma, range.start, range.end);
+    });
+    return luma;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+
+// Luma-only tone changes on 8-bit or 16-bit BGR(A) without a YCrCb round trip.
+// With Cr and Cb held fixed, YCrCb -> BGR is Y plus a per-channel chroma term,
+// so changing Y to Y' just adds (Y' - Y) to B, G and R. Y is the fixed-point
+// BT.601 luma, bit-exact with cv::COLOR_BGR2YCrCb on 8-bit data.
+class LumaShift {
+public:
+    template <typename T>
+    static inline int luma_of(const T* bgr) {
+        // Weights sum to 1 << 14, so 16-bit input still fits in an int
+        return (bgr[0] * 1868 + bgr[1] * 9617 + bgr[2] * 4899 + (1 << 13)) >> 14;
+    }
+
+    // Histogram of Y computed on the fly (Y is not stored): 256 bins for 8-bit
+    // data, 65536 for 16-bit
+    static void luma_histogram(const cv::Mat& bgr, uint32_t* hist);
+
+    // Y as a plane of the input depth, for operations that need a spatial
+    // neighbourhood (CLAHE)
+    static cv::Mat luma_plane(const cv::Mat& bgr);
+
+    // dst = bgr + (new_luma(y, x, Y) - Y) per pixel, saturated; extra channels copied
+    template <typename LumaMap>
+    static cv::Mat apply(const cv::Mat& bgr, LumaMap new_luma) {
+        CV_Assert((bgr.depth() == CV_8U || bgr.depth() == CV_16U) && bgr.channels() >= 3);
+        cv::Mat dst(bgr.size(), bgr.type());
+        if (bgr.depth() == CV_8U) shift_rows<uchar>(bgr, dst, new_luma);
+        else                      shift_rows<uint16_t>(bgr, dst, new_luma);
+        return dst;
+    }
+
+private:
+    template <typename T, typename LumaMap>
+    static void shift_rows(const cv::Mat& bgr, cv::Mat& dst, LumaMap& new_luma) {
+        const int cn = bgr.channels();
+        cv::parallel_for_(cv::Range(0, bgr.rows), [&](const cv::Range& range) {
+            for (int y = range.start; y < range.end; y++) {
+                const T* p = bgr.ptr<T>(y);
+                T* out = dst.ptr<T>(y);
+                for (int x = 0; x < bgr.cols; x++, p += cn, out += cn) {
+                    int Y = luma_of(p);
+                    int delta = new_luma(y, x, Y) - Y;
+                    out[0] = cv::saturate_cast<T>(p[0] + delta);
+                    out[1] = cv::saturate_cast<T>(p[1] + delta);
+                    out[2] = cv::saturate_cast<T>(p[2] + delta);
+                    for (int c = 3; c < cn; c++) out[c] = p[c];
+                }
+            }
+        });
+    }
+};
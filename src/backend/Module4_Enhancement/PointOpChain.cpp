@@ -0,0 +1,105 @@
+#include "PointOpChain.h"
+#include <algorithm>
+#include <cmath>
+
+PointOpChain::PointOpChain(int depth)
+    : depth_(depth), max_value_(depth == CV_16U ? 65535 : 255) {
+    CV_Assert(depth == CV_8U || depth == CV_16U);
+    std::vector<uint16_t> identity(max_value_ + 1);
+    for (int v = 0; v <= max_value_; v++) identity[v] = (uint16_t)v;
+    tables_.push_back(identity);
+}
+
+void PointOpChain::expand_channels(int channels) {
+    if ((int)tables_.size() == channels) return;
+    CV_Assert(tables_.size() == 1 && channels >= 1);
+    tables_.resize(channels, tables_[0]);
+}
+
+PointOpChain& PointOpChain::append(const std::function<double(int)>& op) {
+    // Evaluate the new op once per value, then compose through it
+    std::vector<uint16_t> step(max_value_ + 1);
+    for (int v = 0; v <= max_value_; v++)
+        step[v] = (uint16_t)std::min<double>(max_value_, std::max(0.0, std::round(op(v))));
+    for (auto& table : tables_)
+        for (uint16_t& entry : table) entry = step[entry];
+    return *this;
+}
+
+PointOpChain& PointOpChain::append_per_channel(int channels, const std::function<double(int, int)>& op) {
+    expand_channels(channels);
+    std::vector<uint16_t> step(max_value_ + 1);
+    for (int c = 0; c < channels; c++) {
+        for (int v = 0; v <= max_value_; v++)
+            step[v] = (uint16_t)std::min<double>(max_value_, std::max(0.0, std::round(op(c, v))));
+        for (uint16_t& entry : tables_[c]) entry = step[entry];
+    }
+    return *this;
+}
+
+PointOpChain& PointOpChain::append_table(const cv::Mat& table) {
+    CV_Assert(table.total() == (size_t)max_value_ + 1);
+    cv::Mat t;
+    table.reshape(table.channels(), 1).convertTo(t, CV_32S);
+    const int cn = t.channels();
+    if (cn == 1) return append([&t](int v) { return (double)t.at<int>(v); });
+    return append_per_channel(cn, [&t, cn](int c, int v) { return (double)t.ptr<int>(0)[v * cn + c]; });
+}
+
+PointOpChain& PointOpChain::append_gamma(double gamma) {
+    CV_Assert(gamma > 0);
+    const double max = max_value_, exponent = 1.0 / gamma;
+    return append([max, exponent](int v) { return max * std::pow(v / max, exponent); });
+}
+
+PointOpChain& PointOpChain::append_linear(double scale, double offset) {
+    return append([scale, offset](int v) { return v * scale + offset; });
+}
+
+bool PointOpChain::is_identity() const {
+    for (const auto& table : tables_)
+        for (int v = 0; v <= max_value_; v++)
+            if (table[v] != v) return false;
+    return true;
+}
+
+cv::Mat PointOpChain::lut() const {
+    const int cn = (int)tables_.size();
+    cv::Mat out(1, max_value_ + 1, CV_MAKETYPE(depth_, cn));
+    for (int c = 0; c < cn; c++)
+        for (int v = 0; v <= max_value_; v++) {
+            if (depth_ == CV_8U) out.ptr<uchar>(0)[v * cn + c] = (uchar)tables_[c][v];
+            else                 out.ptr<uint16_t>(0)[v * cn + c] = tables_[c][v];
+        }
+    return out;
+}
+
+cv::Mat PointOpChain::apply(const cv::Mat& image) const {
+    CV_Assert(image.depth() == depth_);
+    const int cn = image.channels();
+    CV_Assert(tables_.size() == 1 || (int)tables_.size() == cn);
+
+    if (depth_ == CV_8U) {
+        cv::Mat out;
+        cv::LUT(image, lut(), out);
+        return out;
+    }
+
+    // cv::LUT is 8-bit only; 16-bit is a plain gather per element
+    cv::Mat out(image.size(), image.type());
+    const bool shared = tables_.size() == 1;
+    cv::parallel_for_(cv::Range(0, image.rows), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; y++) {
+            const uint16_t* in = image.ptr<uint16_t>(y);
+            uint16_t* dst = out.ptr<uint16_t>(y);
+            if (shared) {
+                const uint16_t* t = tables_[0].data();
+                for (int i = 0; i < image.cols * cn; i++) dst[i] = t[in[i]];
+            } else {
+                for (int x = 0; x < image.cols; x++)
+                    for (int c = 0; c < cn; c++) dst[x * cn + c] = tables_[c][in[x * cn + c]];
+            }
+        }
+    });
+    return out;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Composition of per-pixel tone mappings on integer images. Each appended op is
+// evaluated once per possible input value (256 entries for 8-bit, 65536 for 16-bit)
+// and folded into the running table, so a chain of any length is applied to the
+// image in a single LUT pass. Every step rounds and saturates as if it had been
+// applied to the image on its own.
+class PointOpChain {
+public:
+    explicit PointOpChain(int depth = CV_8U);
+
+    int depth() const { return depth_; }
+    int max_value() const { return max_value_; }
+
+    // op(value) for every channel; the result is rounded and clamped
+    PointOpChain& append(const std::function<double(int)>& op);
+
+    // op(channel, value), channels = image channel count
+    PointOpChain& append_per_channel(int channels, const std::function<double(int, int)>& op);
+
+    // Existing table: 1 x (max_value + 1), one channel (shared) or one per image channel
+    PointOpChain& append_table(const cv::Mat& table);
+
+    // value -> max * (value / max)^(1 / gamma); gamma > 1 lifts the mid-tones
+    PointOpChain& append_gamma(double gamma);
+
+    // value -> value * scale + offset
+    PointOpChain& append_linear(double scale, double offset);
+
+    bool is_identity() const;
+
+    // Folded table as 1 x (max_value + 1), depth(), 1 or per-channel channels
+    cv::Mat lut() const;
+
+    // One pass over the image (cv::LUT for 8-bit, a parallel gather for 16-bit)
+    cv::Mat apply(const cv::Mat& image) const;
+
+private:
+    int depth_;
+    int max_value_;
+    std::vector<std::vector<uint16_t>> tables_;  // one shared table, or one per channel
+
+    void expand_channels(int channels);
+};
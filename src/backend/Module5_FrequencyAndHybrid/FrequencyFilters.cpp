@@ -1,4 +1,9 @@
 #include "FrequencyFilters.h"
+#include "../core/FFTBackend.h"
+#include "../core/GaussianEngine.h"
+#include <algorithm>
+#include <mutex>
+#include <vector>
 
 void FrequencyFilters::shiftDFT(cv::Mat& f) {
     int cx = f.cols / 2;
@@ -29,37 +34,182 @@ cv::Mat FrequencyFilters::createGaussianMask(cv::Size size, float D0, bool isLow
     return complexMask;
 }
 
-cv::Mat FrequencyFilters::applyFilter(const cv::Mat& input, float D0, FilterType type) {
-    if (input.empty()) return cv::Mat();
-    
-    cv::Mat gray;
-    if (input.channels() > 1) cv::cvtColor(input, gray, cv::COLOR_BGR2GRAY); else gray = input.clone();
+// Masks only depend on (size, D0, type), so repeated applies and the three colour
+// planes all share one instance instead of rebuilding it per plane.
+cv::Mat FrequencyFilters::getCachedMask(cv::Size size, float D0, bool isLowPass) {
+    struct Entry { cv::Size size; float D0; bool isLowPass; cv::Mat mask; };
+    static std::mutex cacheMutex;
+    static std::vector<Entry> cache;
+    const size_t maxEntries = 4;
 
-    // Force dimensions to be even for DFT
-    int r = gray.rows & -2;
-    int c = gray.cols & -2;
-    gray = gray(cv::Rect(0, 0, c, r)).clone();
-    gray.convertTo(gray, CV_32F);
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    for (size_t i = 0; i < cache.size(); i++) {
+        if (cache[i].size == size && cache[i].D0 == D0 && cache[i].isLowPass == isLowPass) {
+            Entry hit = cache[i];
+            cache.erase(cache.begin() + i);
+            cache.push_back(hit); // most recently used at the back
+            return hit.mask;
+        }
+    }
+
+    cv::Mat mask = createGaussianMask(size, D0, isLowPass);
+    if (cache.size() >= maxEntries) cache.erase(cache.begin());
+    cache.push_back({size, D0, isLowPass, mask});
+    return mask;
+}
+
+// Log-magnitude of an already centred spectrum, sampled straight onto a display
+// grid (at most SPECTRUM_MAX_SIDE per side), so cost is independent of image size.
+cv::Mat FrequencyFilters::renderSpectrum(const cv::Mat& shifted, const cv::Mat& mask, float D0) {
+    const int SPECTRUM_MAX_SIDE = 512;
+    double scale = std::min(1.0, (double)SPECTRUM_MAX_SIDE / std::max(shifted.cols, shifted.rows));
+    int dw = std::max(1, cvRound(shifted.cols * scale));
+    int dh = std::max(1, cvRound(shifted.rows * scale));
+
+    std::vector<int> srcX(dw);
+    for (int j = 0; j < dw; j++) srcX[j] = std::min(shifted.cols - 1, (int)((j + 0.5) / scale));
+
+    cv::Mat logMag(dh, dw, CV_32F), passBand(dh, dw, CV_32F);
+    for (int i = 0; i < dh; i++) {
+        int sy = std::min(shifted.rows - 1, (int)((i + 0.5) / scale));
+        const cv::Vec2f* F = shifted.ptr<cv::Vec2f>(sy);
+        const cv::Vec2f* M = mask.ptr<cv::Vec2f>(sy);
+        float* L = logMag.ptr<float>(i);
+        float* P = passBand.ptr<float>(i);
+        for (int j = 0; j < dw; j++) {
+            const cv::Vec2f& f = F[srcX[j]];
+            L[j] = std::log(1.0f + std::sqrt(f[0] * f[0] + f[1] * f[1]));
+            P[j] = M[srcX[j]][0];
+        }
+    }
+    cv::normalize(logMag, logMag, 0, 255, cv::NORM_MINMAX);
+
+    // Pass band at full brightness, stop band dimmed and tinted with the accent violet
+    const cv::Vec3f accent(207, 79, 91);
+    cv::Mat view(dh, dw, CV_8UC3);
+    for (int i = 0; i < dh; i++) {
+        const float* L = logMag.ptr<float>(i);
+        const float* P = passBand.ptr<float>(i);
+        cv::Vec3b* out = view.ptr<cv::Vec3b>(i);
+        for (int j = 0; j < dw; j++) {
+            float v = L[j], m = P[j];
+            for (int c = 0; c < 3; c++)
+                out[j][c] = cv::saturate_cast<uchar>(m * v + (1.0f - m) * (0.3f * v + 0.25f * accent[c]));
+        }
+    }
+
+    // D0 contour (the mask is isotropic in frequency samples, the display scale uniform)
+    cv::Point center(cvRound(shifted.cols / 2 * scale), cvRound(shifted.rows / 2 * scale));
+    int radius = std::max(1, cvRound(D0 * scale));
+    cv::circle(view, center, radius, cv::Scalar(255, 255, 255), 1, cv::LINE_AA);
+    return view;
+}
+
+cv::Mat FrequencyFilters::filterPlane(const cv::Mat& plane, const cv::Mat& mask, float D0,
+                                      cv::Mat* spectrum) {
+    FFTBackend& fft = FFTBackend::active();
 
-    // DFT
-    cv::Mat planes[] = {gray, cv::Mat::zeros(gray.size(), CV_32F)};
+    // DFT (planned per image size, warm after the first run or from wisdom)
     cv::Mat complexI;
-    cv::merge(planes, 2, complexI);
-    cv::dft(complexI, complexI);
+    fft.forward(plane, complexI);
     shiftDFT(complexI);
+    if (spectrum) *spectrum = renderSpectrum(complexI, mask, D0);
 
     // Apply Mask
-    cv::Mat mask = createGaussianMask(gray.size(), D0, (type == LOW_PASS));
     cv::multiply(complexI, mask, complexI);
 
     // Inverse DFT
     shiftDFT(complexI);
-    cv::idft(complexI, complexI);
+    fft.inverse(complexI, complexI);
+    cv::Mat planes[2];
     cv::split(complexI, planes);
     cv::Mat result;
     cv::magnitude(planes[0], planes[1], result);
+    return result;
+}
+
+cv::Mat FrequencyFilters::filterPlanes(const cv::Mat& input32f, float D0, bool isLowPass,
+                                       cv::Mat* spectrum) {
+    CV_Assert(input32f.depth() == CV_32F);
+    CV_Assert(input32f.rows % 2 == 0 && input32f.cols % 2 == 0);
+
+    // The centred mask is a Gaussian blur in disguise; for small spatial sigmas a
+    // separable or recursive blur is far cheaper than the full-image DFT.
+    double sigmaX = GaussianEngine::sigmaFromCutoff(input32f.cols, D0);
+    double sigmaY = GaussianEngine::sigmaFromCutoff(input32f.rows, D0);
+    GaussianEngine::Backend backend =
+        GaussianEngine::choose(input32f.size(), input32f.channels(), sigmaX, sigmaY);
+    if (backend != GaussianEngine::FFT && !spectrum) {
+        cv::Mat low = GaussianEngine::blur(input32f, sigmaX, sigmaY, backend);
+        cv::Mat result = isLowPass ? cv::abs(low) : cv::abs(input32f - low);
+        return result;
+    }
+
+    cv::Mat mask = getCachedMask(input32f.size(), D0, isLowPass);
+
+    std::vector<cv::Mat> planes;
+    cv::split(input32f, planes);
+    std::vector<cv::Mat> filtered(planes.size());
+    // For BGR the green plane stands in for luminance
+    int spectrumPlane = (planes.size() >= 3) ? 1 : 0;
+
+    // One FFT pair per plane, run side by side
+    cv::parallel_for_(cv::Range(0, (int)planes.size()), [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; i++)
+            filtered[i] = filterPlane(planes[i], mask, D0, (i == spectrumPlane) ? spectrum : nullptr);
+    });
+
+    if (filtered.size() == 1) return filtered[0];
+    cv::Mat result;
+    cv::merge(filtered, result);
+    return result;
+}
+
+cv::Mat FrequencyFilters::applyFilter(const cv::Mat& input, float D0, FilterType type,
+                                      ColorMode mode, double* elapsedMs, cv::Mat* spectrum) {
+    if (input.empty()) return cv::Mat();
+    int64 start = cv::getTickCount();
+    bool isLowPass = (type == LOW_PASS);
+
+    // Force dimensions to be even for DFT
+    cv::Rect even(0, 0, input.cols & -2, input.rows & -2);
+    cv::Mat result;
+
+    if (mode == GRAYSCALE || input.channels() == 1) {
+        cv::Mat gray;
+        if (input.channels() > 1) cv::cvtColor(input(even), gray, cv::COLOR_BGR2GRAY); else gray = input(even);
+        gray.convertTo(gray, CV_32F);
+
+        result = filterPlanes(gray, D0, isLowPass, spectrum);
+        cv::normalize(result, result, 0, 255, cv::NORM_MINMAX);
+        result.convertTo(result, CV_8U);
+    } else if (mode == COLOR_BGR) {
+        cv::Mat bgr;
+        input(even).convertTo(bgr, CV_32F);
+
+        result = filterPlanes(bgr, D0, isLowPass, spectrum);
+        // A single min/max across all planes keeps the colour balance
+        cv::Mat flat = result.reshape(1);
+        cv::normalize(flat, flat, 0, 255, cv::NORM_MINMAX);
+        result.convertTo(result, CV_8U);
+    } else {
+        cv::Mat ycrcb;
+        cv::cvtColor(input(even), ycrcb, cv::COLOR_BGR2YCrCb);
+        std::vector<cv::Mat> channels;
+        cv::split(ycrcb, channels);
+
+        cv::Mat luma;
+        channels[0].convertTo(luma, CV_32F);
+        luma = filterPlanes(luma, D0, isLowPass, spectrum);
+        // Y goes back in at the chroma's depth so 16-bit input stays 16-bit
+        double peak = (channels[1].depth() == CV_16U) ? 65535.0 : 255.0;
+        cv::normalize(luma, luma, 0, peak, cv::NORM_MINMAX);
+        luma.convertTo(channels[0], channels[1].depth());
+
+        cv::merge(channels, ycrcb);
+        cv::cvtColor(ycrcb, result, cv::COLOR_YCrCb2BGR);
+    }
 
-    cv::normalize(result, result, 0, 255, cv::NORM_MINMAX);
-    result.convertTo(result, CV_8U);
+    if (elapsedMs) *elapsedMs = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
     return result;
 }
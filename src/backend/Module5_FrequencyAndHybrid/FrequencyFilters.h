@@ -6,11 +6,33 @@
 class FrequencyFilters {
 public:
     enum FilterType { LOW_PASS, HIGH_PASS };
-    static cv::Mat applyFilter(const cv::Mat& input, float D0, FilterType type);
+
+    // GRAYSCALE: legacy single-plane output
+    // COLOR_BGR: B, G and R filtered concurrently with one shared mask
+    // COLOR_LUMA: only Y of YCrCb is filtered, chroma passes through (~1/3 the cost)
+    enum ColorMode { GRAYSCALE, COLOR_BGR, COLOR_LUMA };
+
+    // elapsedMs (optional) receives the wall time of the whole call.
+    // spectrum (optional) receives the centred log-magnitude spectrum with the mask
+    // overlaid, sampled from the filter's own forward DFT at display resolution.
+    static cv::Mat applyFilter(const cv::Mat& input, float D0, FilterType type,
+                               ColorMode mode = GRAYSCALE, double* elapsedMs = nullptr,
+                               cv::Mat* spectrum = nullptr);
+
+    // Filters every plane of an even-sized CV_32F image (1..4 channels) and returns
+    // the raw magnitudes, unnormalized. Planes are transformed concurrently.
+    // Small kernels are routed to GaussianEngine's spatial/recursive backends
+    // unless a spectrum is requested, which needs the DFT path.
+    static cv::Mat filterPlanes(const cv::Mat& input32f, float D0, bool isLowPass,
+                                cv::Mat* spectrum = nullptr);
 
 private:
     static void shiftDFT(cv::Mat& f);
     static cv::Mat createGaussianMask(cv::Size size, float D0, bool isLowPass);
+    static cv::Mat getCachedMask(cv::Size size, float D0, bool isLowPass);
+    static cv::Mat filterPlane(const cv::Mat& plane, const cv::Mat& mask, float D0,
+                               cv::Mat* spectrum = nullptr);
+    static cv::Mat renderSpectrum(const cv::Mat& shifted, const cv::Mat& mask, float D0);
 };
 
 #endif
@@ -2,11 +2,15 @@
 #define HYBRIDIMAGEBUILDER_H
 
 #include <opencv2/opencv.hpp>
+#include "FrequencyFilters.h"
 
 class HybridImageBuilder {
 public:
     // sigma determines the "cutoff". Standard value is around 5-15.
-    static cv::Mat createHybrid(cv::Mat img1, cv::Mat img2, int sigma);
+    // In COLOR_LUMA mode the chroma of img1 (the low-frequency image) is kept.
+    static cv::Mat createHybrid(cv::Mat img1, cv::Mat img2, int sigma,
+                                FrequencyFilters::ColorMode mode = FrequencyFilters::GRAYSCALE,
+                                double* elapsedMs = nullptr);
 };
 
 #endif
@@ -0,0 +1,197 @@
+#include "Convolution.h"
+#include "FFTBackend.h"
+#include <opencv2/core/utils/logger.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Kernels up to this area always go to filter2D, without sizing any transform
+const int DIRECT_MAX_AREA = 11 * 11;
+
+// Calibrated by Convolution::calibrate(). fftPerTap is the cost of one FFT round
+// trip per sample per log2(area), in units of one direct multiply-add; the
+// default assumes ~5 n log n per transform.
+std::atomic<int> tileSide{512};
+std::atomic<double> fftPerTap{10.0};
+
+double elapsedMs(int64 start) {
+    return (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+}
+
+// Relative cost per output sample along one axis of a transform of size n whose
+// useful (non-overlap) part is `tile` samples.
+double axisCost(int n, int tile) {
+    return n * std::log2((double)n) / tile;
+}
+
+} // namespace
+
+int Convolution::cacheFriendlySide() {
+    return tileSide.load();
+}
+
+// Square forward + inverse transforms of growing side. Cost per sample normalised
+// by log2(area) is flat while the spectrum stays in cache; the tile cap is the
+// last side before it rises by more than a quarter over the best seen. Kernels
+// wider than half that side force bigger tiles regardless. The best cost over one
+// direct tap (filter2D with a 7x7 kernel, below its own DFT switch-over) is the
+// FFT weight in AUTO.
+void Convolution::calibrate() {
+    static std::once_flag once;
+    std::call_once(once, []() {
+        FFTBackend& fft = FFTBackend::active();
+        double best = 1e300;
+        int side = 128;
+        std::string log;
+        for (int n = 128; n <= 2048; n *= 2) {
+            cv::Mat probe(n, n, CV_32F), spectrum;
+            cv::randu(probe, 0, 1);
+            double ms = 1e12;
+            for (int i = 0; i < 2; i++) {
+                int64 t = cv::getTickCount();
+                fft.forward(probe, spectrum);
+                fft.inverse(spectrum, spectrum, true);
+                ms = std::min(ms, elapsedMs(t));
+            }
+            double area = (double)n * n;
+            double cost = ms / (area * std::log2(area));
+            log += " " + std::to_string(n) + ":" + std::to_string(cost * 1e6);
+            if (cost > 1.25 * best) break;
+            best = std::min(best, cost);
+            side = n;
+        }
+
+        cv::Mat probe(512, 512, CV_32F), filtered;
+        cv::randu(probe, 0, 1);
+        cv::Mat kernel(7, 7, CV_32F, cv::Scalar(1.0f / 49));
+        double directMs = 1e12;
+        for (int i = 0; i < 2; i++) {
+            int64 t = cv::getTickCount();
+            cv::filter2D(probe, filtered, -1, kernel, cv::Point(-1, -1), 0, cv::BORDER_REFLECT_101);
+            directMs = std::min(directMs, elapsedMs(t));
+        }
+        double perTap = std::max(directMs / (probe.total() * 49.0), 1e-12);
+
+        tileSide = side;
+        fftPerTap = best / perTap;
+        CV_LOG_INFO(NULL, "Convolution tile side " << side << ", FFT weight " << best / perTap
+                    << " taps (ns per sample*log2, by side:" << log << "; ns per tap: " << perTap * 1e6 << ")");
+    });
+}
+
+int Convolution::chooseTransformSize(int kernelExtent, int imageExtent) {
+    int k = kernelExtent;
+    int needed = imageExtent + k - 1;  // the whole axis in one tile
+
+    // Tiles must be at least k-1 long so overlap only spills into the next tile;
+    // if a single tile covers the axis that constraint disappears.
+    int minN = cv::getOptimalDFTSize(std::min(2 * k, needed));
+    int maxN = std::max(minN, std::min(cacheFriendlySide(), cv::getOptimalDFTSize(needed)));
+
+    int best = minN;
+    double bestCost = 1e300;
+    for (int n = minN; n <= maxN; n = cv::getOptimalDFTSize(n + 1)) {
+        int tile = std::min(n - k + 1, imageExtent);
+        double cost = axisCost(n, tile);
+        if (cost < bestCost) { bestCost = cost; best = n; }
+    }
+    return best;
+}
+
+cv::Mat Convolution::overlapAdd(const cv::Mat& plane32f, const cv::Mat& kernel32f) {
+    const int kh = kernel32f.rows, kw = kernel32f.cols;
+    const int Ny = chooseTransformSize(kh, plane32f.rows);
+    const int Nx = chooseTransformSize(kw, plane32f.cols);
+    const int Ty = std::min(Ny - kh + 1, plane32f.rows);
+    const int Tx = std::min(Nx - kw + 1, plane32f.cols);
+
+    // Flipped kernel turns the FFT convolution into filter2D's correlation
+    FFTBackend& fft = FFTBackend::active();
+    cv::Mat flipped, kernelPadded = cv::Mat::zeros(Ny, Nx, CV_32F), kernelSpectrum;
+    cv::flip(kernel32f, flipped, -1);
+    flipped.copyTo(kernelPadded(cv::Rect(0, 0, kw, kh)));
+    fft.forward(kernelPadded, kernelSpectrum);
+
+    cv::Mat acc = cv::Mat::zeros(plane32f.rows + kh - 1, plane32f.cols + kw - 1, CV_32F);
+    const int tileRows = (plane32f.rows + Ty - 1) / Ty;
+
+    // A tile row only spills into the next one, so even rows run in parallel,
+    // then odd rows; tiles inside a row are accumulated in order.
+    for (int phase = 0; phase < 2; phase++) {
+        int count = (tileRows - phase + 1) / 2;
+        cv::parallel_for_(cv::Range(0, count), [&](const cv::Range& range) {
+            cv::Mat buffer(Ny, Nx, CV_32F), spectrum, real;
+            for (int idx = range.start; idx < range.end; idx++) {
+                int ty = (2 * idx + phase) * Ty;
+                int th = std::min(Ty, plane32f.rows - ty);
+                for (int tx = 0; tx < plane32f.cols; tx += Tx) {
+                    int tw = std::min(Tx, plane32f.cols - tx);
+
+                    buffer.setTo(0);
+                    plane32f(cv::Rect(tx, ty, tw, th)).copyTo(buffer(cv::Rect(0, 0, tw, th)));
+                    fft.forward(buffer, spectrum);
+                    cv::mulSpectrums(spectrum, kernelSpectrum, spectrum, 0);
+                    fft.inverse(spectrum, spectrum, true);
+
+                    cv::Rect out(0, 0, tw + kw - 1, th + kh - 1);
+                    cv::extractChannel(spectrum(out), real, 0);
+                    cv::Mat dst = acc(cv::Rect(tx, ty, out.width, out.height));
+                    cv::add(dst, real, dst);
+                }
+            }
+        });
+    }
+    return acc;
+}
+
+cv::Mat Convolution::apply(const cv::Mat& input, const cv::Mat& kernel, int ddepth,
+                           Method method, Method* chosen) {
+    if (input.empty()) return cv::Mat();
+    CV_Assert(!kernel.empty() && kernel.channels() == 1);
+    if (ddepth < 0) ddepth = input.depth();
+
+    cv::Mat kernel32f;
+    kernel.convertTo(kernel32f, CV_32F);
+    const int kh = kernel32f.rows, kw = kernel32f.cols;
+
+    if (method == AUTO && kw * kh <= DIRECT_MAX_AREA) method = DIRECT;
+    if (method == AUTO) {
+        // Direct: one multiply-add per tap. FFT: a forward and inverse transform
+        // per tile (fftPerTap taps per sample*log2), spread over the tile's
+        // useful samples.
+        int Ny = chooseTransformSize(kh, input.rows), Nx = chooseTransformSize(kw, input.cols);
+        double tile = (double)std::min(Ny - kh + 1, input.rows) * std::min(Nx - kw + 1, input.cols);
+        double area = (double)Nx * Ny;
+        double fftCost = fftPerTap.load() * area * std::log2(area) / tile;
+        method = (fftCost < (double)kw * kh) ? OVERLAP_ADD : DIRECT;
+    }
+    if (chosen) *chosen = method;
+
+    cv::Mat output;
+    if (method == DIRECT) {
+        cv::filter2D(input, output, ddepth, kernel32f, cv::Point(-1, -1), 0, cv::BORDER_REFLECT_101);
+        return output;
+    }
+
+    // Pad so the valid part of the full convolution lines up with filter2D's
+    // centred anchor
+    int ax = kw / 2, ay = kh / 2;
+    cv::Mat src32f, padded;
+    input.convertTo(src32f, CV_32F);
+    cv::copyMakeBorder(src32f, padded, ay, kh - 1 - ay, ax, kw - 1 - ax, cv::BORDER_REFLECT_101);
+
+    std::vector<cv::Mat> planes;
+    cv::split(padded, planes);
+    for (cv::Mat& plane : planes) {
+        cv::Mat full = overlapAdd(plane, kernel32f);
+        plane = full(cv::Rect(kw - 1, kh - 1, input.cols, input.rows)).clone();
+    }
+    cv::merge(planes, output);
+    if (ddepth != CV_32F) output.convertTo(output, ddepth);
+    return output;
+}
@@ -0,0 +1,40 @@
+#ifndef CONVOLUTION_H
+#define CONVOLUTION_H
+
+#include <opencv2/opencv.hpp>
+
+// General 2D filtering with arbitrary kernels (same semantics as cv::filter2D:
+// correlation, centred anchor, BORDER_REFLECT_101).
+//   DIRECT      - cv::filter2D, cost grows with kernel area
+//   OVERLAP_ADD - tiled FFT convolution; tile and transform sizes are chosen per
+//                 kernel so one tile spectrum stays cache-sized (see
+//                 cacheFriendlySide()), cost per pixel
+//                 grows only with log(tile size). Suited to kernels of hundreds of px.
+// The tile cap and the AUTO crossover start from fixed defaults and switch to
+// measured values once calibrate() has run; the app runs it on a worker at startup.
+class Convolution {
+public:
+    enum Method { AUTO, DIRECT, OVERLAP_ADD };
+
+    // ddepth = -1 keeps the input depth; kernel is converted to CV_32F
+    static cv::Mat apply(const cv::Mat& input, const cv::Mat& kernel, int ddepth = -1,
+                         Method method = AUTO, Method* chosen = nullptr);
+
+    // FFT size per axis for a kernel extent, balancing transform cost against
+    // overlap waste; exposed for benchmarking
+    static int chooseTransformSize(int kernelExtent, int imageExtent);
+
+    // Largest transform side that stays cache-resident: 512 until calibrated
+    static int cacheFriendlySide();
+
+    // Times FFT round trips of growing side and direct filtering per tap on the
+    // active FFT backend, then updates the tile cap and the AUTO cost ratio and
+    // logs them at info level. Runs once per process (later calls return at
+    // once); meant for a background thread, as it takes a few hundred ms.
+    static void calibrate();
+
+private:
+    static cv::Mat overlapAdd(const cv::Mat& plane32f, const cv::Mat& kernel32f);
+};
+
+#endif // CONVOLUTION_H
@@ -0,0 +1,58 @@
+#include "EncodeQueue.h"
+#include <opencv2/core/utils/logger.hpp>
+#include <algorithm>
+#include <utility>
+
+EncodeQueue::EncodeQueue(int workerCount, size_t queueCapacity, std::vector<int> writeParams)
+    : params(std::move(writeParams)), capacity(std::max<size_t>(1, queueCapacity)) {
+    if (workerCount <= 0) workerCount = std::max(1, (int)std::thread::hardware_concurrency() / 2);
+    for (int i = 0; i < workerCount; i++) workers.emplace_back(&EncodeQueue::run, this);
+}
+
+EncodeQueue::~EncodeQueue() {
+    finish();
+}
+
+void EncodeQueue::push(const std::string& path, const cv::Mat& image) {
+    std::unique_lock<std::mutex> lock(mutex);
+    notFull.wait(lock, [this]() { return jobs.size() < capacity || closing; });
+    if (closing) return;
+    jobs.push_back(Job{path, image});
+    notEmpty.notify_one();
+}
+
+void EncodeQueue::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closing && workers.empty()) return;
+        closing = true;
+    }
+    notEmpty.notify_all();
+    notFull.notify_all();
+    for (std::thread& t : workers) t.join();
+    workers.clear();
+}
+
+void EncodeQueue::run() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            // Workers drain what is left before honouring `closing`
+            notEmpty.wait(lock, [this]() { return !jobs.empty() || closing; });
+            if (jobs.empty()) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        notFull.notify_one();
+
+        bool ok = false;
+        try {
+            ok = cv::imwrite(job.path, job.image, params);
+        } catch (const cv::Exception& e) {
+            CV_LOG_WARNING(NULL, "EncodeQueue: " << job.path << ": " << e.what());
+        }
+        if (ok) writtenCount++;
+        else    failedCount++;
+    }
+}
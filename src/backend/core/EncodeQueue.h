@@ -0,0 +1,50 @@
+#ifndef ENCODEQUEUE_H
+#define ENCODEQUEUE_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Bounded producer/consumer queue that writes images to disk on worker threads.
+// Producers block in push() once `capacity` images are waiting, so memory stays
+// bounded however fast images are generated. Defaults favour throughput: PNG at
+// compression level 1.
+class EncodeQueue {
+public:
+    // workerCount <= 0 uses half the hardware threads (at least one)
+    explicit EncodeQueue(int workerCount = 0, size_t queueCapacity = 32,
+                         std::vector<int> writeParams = {cv::IMWRITE_PNG_COMPRESSION, 1});
+    ~EncodeQueue();
+
+    EncodeQueue(const EncodeQueue&) = delete;
+    EncodeQueue& operator=(const EncodeQueue&) = delete;
+
+    // The image is shared, not copied; the caller must not modify it afterwards
+    void push(const std::string& path, const cv::Mat& image);
+
+    // Waits for every queued image and stops the workers; push() is invalid after
+    void finish();
+
+    int written() const { return writtenCount; }
+    int failed() const { return failedCount; }
+
+private:
+    struct Job { std::string path; cv::Mat image; };
+    void run();
+
+    std::vector<int> params;
+    size_t capacity;
+    std::deque<Job> jobs;
+    std::mutex mutex;
+    std::condition_variable notEmpty, notFull;
+    bool closing = false;
+    std::vector<std::thread> workers;
+    std::atomic<int> writtenCount{0}, failedCount{0};
+};
+
+#endif // ENCODEQUEUE_H
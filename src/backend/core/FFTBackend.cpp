@@ -0,0 +1,278 @@
+#include "FFTBackend.h"
+#include <opencv2/core/utils/logger.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#ifdef TASK1_WITH_FFTW
+#include <fftw3.h>
+#endif
+
+std::string FFTBackend::wisdomDirectory = ".";
+
+namespace {
+
+// New measured plans written per wisdom save, and plans kept in the file
+const int WISDOM_BATCH = 16;
+const size_t MAX_WISDOM_PLANS = 256;
+
+// ── Default backend: cv::dft, nothing to prepare and no wisdom to keep ──
+class OpenCVFFTBackend : public FFTBackend {
+public:
+    const char* name() const override { return "opencv"; }
+
+protected:
+    void execute(const Plan& plan, const cv::Mat& src, cv::Mat& dst) override {
+        int flags = (plan.direction == INVERSE) ? cv::DFT_INVERSE : 0;
+        if (src.channels() == 1) flags |= cv::DFT_COMPLEX_OUTPUT;
+        cv::dft(src, dst, flags);
+    }
+};
+
+#ifdef TASK1_WITH_FFTW
+// ── FFTW3 (single precision). Plans are made with FFTW_UNALIGNED so one plan can
+//    run on any buffer through the new-array execute interface. ──
+class FFTWBackend : public FFTBackend {
+public:
+    ~FFTWBackend() override {
+        for (auto& kv : fftwPlans) fftwf_destroy_plan(kv.second);
+    }
+    const char* name() const override { return "fftw"; }
+
+protected:
+    void prepare(const Plan& plan) override {
+        // FFTW_MEASURE on very large sizes takes minutes; estimate those instead
+        unsigned flags = FFTW_UNALIGNED | (plan.size.area() <= (1 << 22) ? FFTW_MEASURE : FFTW_ESTIMATE);
+        cv::Mat in(plan.size, CV_32FC2), out(plan.size, CV_32FC2);
+        fftwf_plan p = fftwf_plan_dft_2d(plan.size.height, plan.size.width,
+                                         reinterpret_cast<fftwf_complex*>(in.data),
+                                         reinterpret_cast<fftwf_complex*>(out.data),
+                                         plan.direction == FORWARD ? FFTW_FORWARD : FFTW_BACKWARD,
+                                         flags);
+        std::lock_guard<std::mutex> lock(fftwMutex);
+        fftwPlans[keyOf(plan)] = p;
+    }
+
+    void execute(const Plan& plan, const cv::Mat& src, cv::Mat& dst) override {
+        cv::Mat in = src;
+        if (in.channels() == 1) {
+            cv::Mat planes[] = {src, cv::Mat::zeros(src.size(), CV_32F)};
+            cv::merge(planes, 2, in);
+        } else if (!in.isContinuous()) {
+            in = in.clone();
+        }
+
+        fftwf_plan p;
+        {
+            std::lock_guard<std::mutex> lock(fftwMutex);
+            p = fftwPlans.at(keyOf(plan));
+        }
+        // Always a fresh output: the plans are out-of-place
+        cv::Mat out(plan.size, CV_32FC2);
+        fftwf_execute_dft(p, reinterpret_cast<fftwf_complex*>(in.data),
+                          reinterpret_cast<fftwf_complex*>(out.data));
+        dst = out;
+    }
+
+    bool hasWisdom() const override { return true; }
+
+    std::string exportWisdom() override {
+        char* wisdom = fftwf_export_wisdom_to_string();
+        if (!wisdom) return std::string();
+        std::string copy(wisdom);
+        free(wisdom);
+        return copy;
+    }
+
+    void importWisdom(const std::string& wisdom) override {
+        if (!wisdom.empty()) fftwf_import_wisdom_from_string(wisdom.c_str());
+    }
+
+private:
+    typedef std::pair<std::pair<int, int>, int> Key;
+    static Key keyOf(const Plan& plan) {
+        return {{plan.size.width, plan.size.height}, (int)plan.direction};
+    }
+
+    std::mutex fftwMutex;
+    std::map<Key, fftwf_plan> fftwPlans;
+};
+#endif
+
+std::unique_ptr<FFTBackend>& instance() {
+    static std::unique_ptr<FFTBackend> backend;
+    return backend;
+}
+
+} // namespace
+
+FFTBackend& FFTBackend::active() {
+    static std::once_flag once;
+    std::call_once(once, []() {
+        if (instance()) return;
+        const char* env = std::getenv("TASK1_FFT_BACKEND");
+        if (!(env && select(env))) instance().reset(new OpenCVFFTBackend());
+    });
+    return *instance();
+}
+
+bool FFTBackend::select(const std::string& name) {
+    if (name == "opencv") {
+        instance().reset(new OpenCVFFTBackend());
+        return true;
+    }
+#ifdef TASK1_WITH_FFTW
+    if (name == "fftw") {
+        instance().reset(new FFTWBackend());
+        return true;
+    }
+#endif
+    CV_LOG_WARNING(NULL, "FFTBackend: unknown or unavailable backend '" << name << "'");
+    return false;
+}
+
+void FFTBackend::setWisdomDirectory(const std::string& directory) {
+    wisdomDirectory = directory;
+}
+
+std::string FFTBackend::wisdomFile() const {
+    return wisdomDirectory + "/fft_wisdom_" + name() + ".yml";
+}
+
+void FFTBackend::loadWisdom() {
+    if (!hasWisdom()) return;
+    try {
+        cv::FileStorage fs(wisdomFile(), cv::FileStorage::READ);
+        if (!fs.isOpened()) return;
+
+        cv::FileNode list = fs["plans"];
+        for (cv::FileNodeIterator it = list.begin(); it != list.end(); ++it) {
+            cv::FileNode n = *it;
+            Plan p;
+            p.size = cv::Size((int)n["w"], (int)n["h"]);
+            p.direction = (Direction)(int)n["dir"];
+            p.measuredMs = (double)n["ms"];
+            if (p.size.area() > 0) {
+                PlanKey key{{p.size.width, p.size.height}, (int)p.direction};
+                plans[key] = p;
+                lastUse[key] = ++useClock; // file order is oldest first
+            }
+        }
+        importWisdom((std::string)fs["fftw_wisdom"]);
+        CV_LOG_INFO(NULL, "FFTBackend(" << name() << "): restored " << plans.size() << " plans from " << wisdomFile());
+    } catch (const cv::Exception&) {
+        // A damaged wisdom file only costs us the planning step
+        plans.clear();
+    }
+}
+
+FFTBackend::WisdomSnapshot FFTBackend::snapshotWisdom() {
+    // Only sizes that ran, the most recently used ones, oldest first
+    std::vector<std::pair<uint64_t, PlanKey>> order;
+    for (const auto& kv : plans)
+        if (kv.second.measuredMs > 0) order.push_back({lastUse[kv.first], kv.first});
+    std::sort(order.begin(), order.end());
+    size_t first = order.size() > MAX_WISDOM_PLANS ? order.size() - MAX_WISDOM_PLANS : 0;
+
+    WisdomSnapshot snapshot;
+    for (size_t i = first; i < order.size(); i++) snapshot.plans.push_back(plans[order[i].second]);
+    snapshot.backendWisdom = exportWisdom();
+    return snapshot;
+}
+
+void FFTBackend::writeWisdom(const WisdomSnapshot& snapshot) {
+    std::lock_guard<std::mutex> lock(wisdomFileMutex);
+    try {
+        cv::FileStorage fs(wisdomFile(), cv::FileStorage::WRITE);
+        if (!fs.isOpened()) return;
+
+        fs << "plans" << "[";
+        for (const Plan& p : snapshot.plans) {
+            fs << "{" << "w" << p.size.width << "h" << p.size.height << "dir" << (int)p.direction
+               << "ms" << p.measuredMs << "}";
+        }
+        fs << "]";
+        if (!snapshot.backendWisdom.empty()) fs << "fftw_wisdom" << snapshot.backendWisdom;
+    } catch (const cv::Exception&) {
+        // Read-only location: keep working with the in-memory plans
+    }
+}
+
+void FFTBackend::flushWisdom() {
+    if (!hasWisdom()) return;
+    WisdomSnapshot snapshot;
+    {
+        std::lock_guard<std::mutex> lock(planMutex);
+        if (unsavedPlans == 0) return;
+        snapshot = snapshotWisdom();
+        unsavedPlans = 0;
+    }
+    writeWisdom(snapshot);
+}
+
+cv::Size FFTBackend::fastSize(cv::Size size) {
+    return cv::Size(cv::getOptimalDFTSize(size.width), cv::getOptimalDFTSize(size.height));
+}
+
+void FFTBackend::run(const Plan& plan, const cv::Mat& src, cv::Mat& dst) {
+    if (plan.measuredMs > 0) {
+        execute(plan, src, dst);
+        return;
+    }
+
+    int64 t = cv::getTickCount();
+    execute(plan, src, dst);
+    double ms = std::max((cv::getTickCount() - t) * 1000.0 / cv::getTickFrequency(), 1e-6);
+
+    WisdomSnapshot snapshot;
+    {
+        std::lock_guard<std::mutex> lock(planMutex);
+        Plan& stored = plans[{{plan.size.width, plan.size.height}, (int)plan.direction}];
+        if (stored.measuredMs > 0) return; // another thread ran it first
+        stored.measuredMs = ms;
+        CV_LOG_INFO(NULL, "FFTBackend(" << name() << "): " << plan.size.width << "x" << plan.size.height
+                    << (plan.direction == FORWARD ? " fwd" : " inv") << " first run " << ms << " ms");
+        if (!hasWisdom() || ++unsavedPlans < WISDOM_BATCH) return;
+        snapshot = snapshotWisdom();
+        unsavedPlans = 0;
+    }
+    // Other FFT threads keep planning while the file is written
+    writeWisdom(snapshot);
+}
+
+FFTBackend::Plan FFTBackend::plan(cv::Size size, Direction direction) {
+    std::lock_guard<std::mutex> lock(planMutex);
+    if (!wisdomLoaded) {
+        loadWisdom();
+        wisdomLoaded = true;
+    }
+
+    PlanKey key{{size.width, size.height}, (int)direction};
+    lastUse[key] = ++useClock;
+    auto it = plans.find(key);
+    if (it != plans.end()) {
+        // Plans restored from wisdom still need prepare() once per process
+        if (prepared.insert(key).second) prepare(it->second);
+        return it->second;
+    }
+
+    // Cold size: prepare only; the first real transform is timed by run()
+    Plan p{size, direction, 0.0};
+    prepare(p);
+    plans.emplace(key, p);
+    prepared.insert(key);
+    return p;
+}
+
+void FFTBackend::forward(const cv::Mat& src, cv::Mat& dst) {
+    CV_Assert(src.depth() == CV_32F && (src.channels() == 1 || src.channels() == 2));
+    Plan p = plan(src.size(), FORWARD);
+    run(p, src, dst);
+}
+
+void FFTBackend::inverse(const cv::Mat& src, cv::Mat& dst, bool scale) {
+    CV_Assert(src.type() == CV_32FC2);
+    Plan p = plan(src.size(), INVERSE);
+    run(p, src, dst);
+    if (scale) dst.convertTo(dst, -1, 1.0 / (double)src.total());
+}
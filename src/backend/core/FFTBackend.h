@@ -0,0 +1,94 @@
+#ifndef FFTBACKEND_H
+#define FFTBACKEND_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Pluggable 2D FFT with per-(size, direction) plan caching. Backends whose plans
+// are expensive to make (FFTW) persist them to a small wisdom file, together with
+// the sizes that actually ran (in batches, capped to the most recently used), so
+// those sizes plan quickly in later sessions. cv::dft has no plans to keep, so the
+// default backend reads and writes no file.
+// Callers that may pad should pad to fastSize() so plans stay keyed on a small
+// set of fast sizes rather than on every raw extent.
+//
+// Backends: "opencv" (default, cv::dft) and "fftw" (built with TASK1_WITH_FFTW).
+// The active backend can be picked with select() or the TASK1_FFT_BACKEND
+// environment variable; do it at startup, before any transform runs.
+class FFTBackend {
+public:
+    enum Direction { FORWARD, INVERSE };
+
+    struct Plan {
+        cv::Size size;          // logical transform size
+        Direction direction;
+        double measuredMs;      // first transform at `size` (logged); 0 until one has run
+    };
+
+    virtual ~FFTBackend() = default;
+    virtual const char* name() const = 0;
+
+    // forward: CV_32FC1 (real) or CV_32FC2 input -> full CV_32FC2 spectrum
+    // inverse: CV_32FC2 -> CV_32FC2, divided by the element count when scale is set
+    void forward(const cv::Mat& src, cv::Mat& dst);
+    void inverse(const cv::Mat& src, cv::Mat& dst, bool scale = false);
+
+    // Cached plan, prepared on first use (or restored from wisdom)
+    Plan plan(cv::Size size, Direction direction);
+    // Smallest fast DFT size >= size; plans nothing
+    static cv::Size fastSize(cv::Size size);
+
+    // Writes plans measured since the last save (wisdom backends only); called at shutdown
+    void flushWisdom();
+
+    static FFTBackend& active();
+    static bool select(const std::string& name);
+    static void setWisdomDirectory(const std::string& directory);
+
+protected:
+    // Backend-specific transform of a continuous CV_32FC2 array of plan.size
+    virtual void execute(const Plan& plan, const cv::Mat& src, cv::Mat& dst) = 0;
+    // Called once per new plan, under the plan lock
+    virtual void prepare(const Plan& plan) { (void)plan; }
+    // Backends with plans worth keeping between sessions override all three;
+    // export and import run under the plan lock, like prepare()
+    virtual bool hasWisdom() const { return false; }
+    virtual std::string exportWisdom() { return std::string(); }
+    virtual void importWisdom(const std::string& wisdom) { (void)wisdom; }
+
+private:
+    typedef std::pair<std::pair<int, int>, int> PlanKey;
+
+    std::mutex planMutex;
+    std::mutex wisdomFileMutex; // file I/O only, never held with planMutex
+    std::map<PlanKey, Plan> plans;
+    std::set<PlanKey> prepared;
+    std::map<PlanKey, uint64_t> lastUse;
+    uint64_t useClock = 0;
+    int unsavedPlans = 0;
+    bool wisdomLoaded = false;
+
+    static std::string wisdomDirectory;
+
+    // Plans and backend wisdom copied under planMutex, written after releasing it
+    struct WisdomSnapshot {
+        std::vector<Plan> plans;
+        std::string backendWisdom;
+    };
+
+    std::string wisdomFile() const;
+    void loadWisdom();
+    WisdomSnapshot snapshotWisdom();
+    void writeWisdom(const WisdomSnapshot& snapshot);
+    // Executes, timing the first run of each plan for the wisdom file
+    void run(const Plan& plan, const cv::Mat& src, cv::Mat& dst);
+};
+
+#endif // FFTBACKEND_H
@@ -0,0 +1,272 @@
+#include "GaussianEngine.h"
+#include "FFTBackend.h"
+#include <opencv2/core/utils/logger.hpp>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+// Young & van Vliet (1995) third-order recursive coefficients, normalised by b0
+struct YvvCoeffs { float B, b1, b2, b3; };
+
+YvvCoeffs yvvCoefficients(double sigma) {
+    double q = (sigma >= 2.5) ? 0.98711 * sigma - 0.96330
+                              : 3.97156 - 4.14554 * std::sqrt(1.0 - 0.26891 * sigma);
+    double q2 = q * q, q3 = q2 * q;
+    double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+    double b1 = 2.44413 * q + 2.85619 * q2 + 1.26661 * q3;
+    double b2 = -(1.4281 * q2 + 1.26661 * q3);
+    double b3 = 0.422205 * q3;
+
+    YvvCoeffs c;
+    c.b1 = (float)(b1 / b0);
+    c.b2 = (float)(b2 / b0);
+    c.b3 = (float)(b3 / b0);
+    c.B  = 1.0f - (c.b1 + c.b2 + c.b3);
+    return c;
+}
+
+// Causal then anti-causal pass down columns [x0, x1) of a plane. Each row step
+// updates every column of the block at once, so the inner loop walks contiguous
+// memory and vectorises; edges start from the steady state of a constant signal,
+// the caller pads with reflected samples beforehand.
+void recursiveColumns(cv::Mat& plane, int x0, int x1, const YvvCoeffs& c) {
+    const int n = x1 - x0, rows = plane.rows;
+    std::vector<float> state(3 * (size_t)n);
+    float* w1 = state.data();
+    float* w2 = w1 + n;
+    float* w3 = w2 + n;
+
+    const float* first = plane.ptr<float>(0) + x0;
+    std::copy(first, first + n, w1);
+    std::copy(first, first + n, w2);
+    std::copy(first, first + n, w3);
+    for (int y = 0; y < rows; y++) {
+        float* row = plane.ptr<float>(y) + x0;
+        for (int i = 0; i < n; i++) {
+            float w = c.B * row[i] + c.b1 * w1[i] + c.b2 * w2[i] + c.b3 * w3[i];
+            w3[i] = w2[i]; w2[i] = w1[i]; w1[i] = w;
+            row[i] = w;
+        }
+    }
+
+    const float* last = plane.ptr<float>(rows - 1) + x0;
+    std::copy(last, last + n, w1);
+    std::copy(last, last + n, w2);
+    std::copy(last, last + n, w3);
+    for (int y = rows - 1; y >= 0; y--) {
+        float* row = plane.ptr<float>(y) + x0;
+        for (int i = 0; i < n; i++) {
+            float w = c.B * row[i] + c.b1 * w1[i] + c.b2 * w2[i] + c.b3 * w3[i];
+            w3[i] = w2[i]; w2[i] = w1[i]; w1[i] = w;
+            row[i] = w;
+        }
+    }
+}
+
+// Column blocks of this width keep the three state rows in L1
+const int RECURSIVE_BLOCK = 256;
+
+void recursiveVertical(cv::Mat& plane, const YvvCoeffs& c) {
+    int blocks = (plane.cols + RECURSIVE_BLOCK - 1) / RECURSIVE_BLOCK;
+    cv::parallel_for_(cv::Range(0, blocks), [&](const cv::Range& range) {
+        for (int b = range.start; b < range.end; b++)
+            recursiveColumns(plane, b * RECURSIVE_BLOCK, std::min(plane.cols, (b + 1) * RECURSIVE_BLOCK), c);
+    });
+}
+
+double elapsedMs(int64 start) {
+    return (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+}
+
+} // namespace
+
+int GaussianEngine::radiusFor(double sigma) {
+    return std::max(1, (int)std::ceil(3.0 * sigma));
+}
+
+double GaussianEngine::sigmaFromCutoff(int length, float D0) {
+    return length / (2.0 * CV_PI * D0);
+}
+
+const char* GaussianEngine::backendName(Backend backend) {
+    switch (backend) {
+        case SPATIAL:   return "spatial";
+        case RECURSIVE: return "recursive";
+        case FFT:       return "fft";
+        default:        return "auto";
+    }
+}
+
+cv::Mat GaussianEngine::blurSpatial(const cv::Mat& src32f, double sigmaX, double sigmaY) {
+    cv::Size ksize(2 * radiusFor(sigmaX) + 1, 2 * radiusFor(sigmaY) + 1);
+    cv::Mat output;
+    cv::GaussianBlur(src32f, output, ksize, sigmaX, sigmaY, cv::BORDER_REFLECT_101);
+    return output;
+}
+
+cv::Mat GaussianEngine::blurRecursive(const cv::Mat& src32f, double sigmaX, double sigmaY) {
+    // Padding only primes the filter state; beyond one image length the reflected
+    // border just repeats, so cap it there to keep sigmas in the hundreds cheap.
+    int rx = std::min(radiusFor(sigmaX), src32f.cols), ry = std::min(radiusFor(sigmaY), src32f.rows);
+    cv::Mat padded;
+    cv::copyMakeBorder(src32f, padded, ry, ry, rx, rx, cv::BORDER_REFLECT_101);
+
+    std::vector<cv::Mat> planes;
+    cv::split(padded, planes);
+    YvvCoeffs cx = yvvCoefficients(sigmaX), cy = yvvCoefficients(sigmaY);
+
+    for (cv::Mat& plane : planes) {
+        // Vertical pass across all columns at once, then the horizontal pass as a
+        // vertical pass over the transpose so both stay contiguous in memory
+        cv::Mat transposed;
+        recursiveVertical(plane, cy);
+        cv::transpose(plane, transposed);
+        recursiveVertical(transposed, cx);
+        cv::transpose(transposed, plane);
+    }
+
+    cv::Mat output;
+    cv::merge(planes, output);
+    return output(cv::Rect(rx, ry, src32f.cols, src32f.rows)).clone();
+}
+
+cv::Mat GaussianEngine::blurFFT(const cv::Mat& src32f, double sigmaX, double sigmaY) {
+    // Reflect-pad at least by the kernel reach and on up to a fast DFT size, the
+    // extra split between both sides, so the circular transform only ever sees
+    // reflected samples around the image, as the spatial and recursive paths do.
+    int rx = radiusFor(sigmaX), ry = radiusFor(sigmaY);
+    FFTBackend& fft = FFTBackend::active();
+    cv::Size fast = FFTBackend::fastSize(cv::Size(src32f.cols + 2 * rx, src32f.rows + 2 * ry));
+    int P = fast.height;
+    int Q = fast.width;
+    int left = rx + (Q - src32f.cols - 2 * rx) / 2, top = ry + (P - src32f.rows - 2 * ry) / 2;
+    cv::Mat padded;
+    cv::copyMakeBorder(src32f, padded, top, P - src32f.rows - top, left, Q - src32f.cols - left,
+                       cv::BORDER_REFLECT_101);
+
+    // Transfer function of a sampled Gaussian is separable: H(u, v) = hx(u) * hy(v)
+    std::vector<float> hx(Q), hy(P);
+    for (int u = 0; u < Q; u++) {
+        double f = std::min(u, Q - u) / (double)Q;
+        hx[u] = (float)std::exp(-2.0 * CV_PI * CV_PI * sigmaX * sigmaX * f * f);
+    }
+    for (int v = 0; v < P; v++) {
+        double f = std::min(v, P - v) / (double)P;
+        hy[v] = (float)std::exp(-2.0 * CV_PI * CV_PI * sigmaY * sigmaY * f * f);
+    }
+
+    std::vector<cv::Mat> planes;
+    cv::split(padded, planes);
+    cv::parallel_for_(cv::Range(0, (int)planes.size()), [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; i++) {
+            cv::Mat spectrum;
+            fft.forward(planes[i], spectrum);
+            for (int v = 0; v < P; v++) {
+                float* row = spectrum.ptr<float>(v);
+                for (int u = 0; u < Q; u++) {
+                    float h = hy[v] * hx[u];
+                    row[2 * u] *= h;
+                    row[2 * u + 1] *= h;
+                }
+            }
+            fft.inverse(spectrum, spectrum, true);
+            cv::extractChannel(spectrum, planes[i], 0);
+        }
+    });
+
+    cv::Mat output;
+    cv::merge(planes, output);
+    return output(cv::Rect(left, top, src32f.cols, src32f.rows)).clone();
+}
+
+// Per-unit costs measured once on a small probe: spatial per tap, recursive per
+// sample and FFT per (P log2 P) of the padded area.
+const GaussianEngine::Costs& GaussianEngine::calibratedCosts() {
+    static Costs costs;
+    static std::once_flag once;
+    std::call_once(once, []() {
+        cv::Mat probe(256, 256, CV_32F);
+        cv::randu(probe, 0, 255);
+        const double sigma = 4.0;
+        const double N = (double)probe.total();
+
+        auto best = [](auto&& run) {
+            double ms = 1e9;
+            for (int i = 0; i < 2; i++) { int64 t = cv::getTickCount(); run(); ms = std::min(ms, elapsedMs(t)); }
+            return std::max(ms, 1e-6);
+        };
+
+        int k = 2 * radiusFor(sigma) + 1;
+        costs.spatial = best([&]() { blurSpatial(probe, sigma, sigma); }) / (N * 2 * k);
+        costs.recursive = best([&]() { blurRecursive(probe, sigma, sigma); }) / N;
+
+        int pad = 2 * radiusFor(sigma);
+        double P = (double)FFTBackend::fastSize(cv::Size(probe.cols + pad, probe.rows + pad)).area();
+        costs.fft = best([&]() { blurFFT(probe, sigma, sigma); }) / (P * std::log2(P));
+
+        CV_LOG_INFO(NULL, "GaussianEngine calibrated (ns/unit): spatial=" << costs.spatial * 1e6
+                    << " recursive=" << costs.recursive * 1e6 << " fft=" << costs.fft * 1e6);
+    });
+    return costs;
+}
+
+GaussianEngine::Backend GaussianEngine::choose(cv::Size size, int channels, double sigmaX, double sigmaY) {
+    // The recursive coefficients are only defined from sigma 0.5 up, and tiny
+    // kernels are never worth a transform.
+    if (sigmaX < 0.5 || sigmaY < 0.5) return SPATIAL;
+
+    const Costs& c = calibratedCosts();
+    int rx = radiusFor(sigmaX), ry = radiusFor(sigmaY);
+    double N = (double)size.area() * channels;
+    double P = (double)FFTBackend::fastSize(cv::Size(size.width + 2 * rx, size.height + 2 * ry)).area();
+
+    double spatial   = c.spatial * N * ((2 * rx + 1) + (2 * ry + 1));
+    double recursive = c.recursive * N;
+    double fft       = c.fft * P * std::log2(P) * channels;
+
+    Backend backend = SPATIAL;
+    double cheapest = spatial;
+    if (recursive < cheapest) { backend = RECURSIVE; cheapest = recursive; }
+    if (fft < cheapest)       { backend = FFT;       cheapest = fft; }
+
+    // Sweeps and batches repeat the same decision many times; log each one once
+    static std::mutex logMutex;
+    static std::set<std::tuple<int, int, int, double, double, int>> logged;
+    {
+        std::lock_guard<std::mutex> lock(logMutex);
+        if (!logged.insert(std::make_tuple(size.width, size.height, channels, sigmaX, sigmaY, (int)backend)).second)
+            return backend;
+    }
+    CV_LOG_INFO(NULL, "GaussianEngine " << size.width << "x" << size.height << "x" << channels
+                << " sigma=(" << sigmaX << ", " << sigmaY << ") -> " << backendName(backend)
+                << " [est ms: spatial=" << spatial << " recursive=" << recursive << " fft=" << fft << "]");
+    return backend;
+}
+
+cv::Mat GaussianEngine::blur(const cv::Mat& input, double sigmaX, double sigmaY,
+                             Backend backend, Backend* chosen) {
+    if (input.empty()) return cv::Mat();
+    if (sigmaY <= 0) sigmaY = sigmaX;
+
+    if (backend == AUTO) backend = choose(input.size(), input.channels(), sigmaX, sigmaY);
+    if (backend == RECURSIVE && (sigmaX < 0.5 || sigmaY < 0.5)) backend = SPATIAL;
+    if (chosen) *chosen = backend;
+
+    cv::Mat src32f;
+    input.convertTo(src32f, CV_32F);
+
+    cv::Mat output;
+    switch (backend) {
+        case RECURSIVE: output = blurRecursive(src32f, sigmaX, sigmaY); break;
+        case FFT:       output = blurFFT(src32f, sigmaX, sigmaY); break;
+        default:        output = blurSpatial(src32f, sigmaX, sigmaY); break;
+    }
+
+    if (input.depth() != CV_32F) output.convertTo(output, input.depth());
+    return output;
+}
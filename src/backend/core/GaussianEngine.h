@@ -0,0 +1,41 @@
+#ifndef GAUSSIANENGINE_H
+#define GAUSSIANENGINE_H
+
+#include <opencv2/opencv.hpp>
+
+// Gaussian blur with three interchangeable implementations and a cost model that
+// picks the cheapest one for a given image size and sigma.
+//   SPATIAL   - separable kernel, cost grows with sigma
+//   RECURSIVE - Young / van Vliet IIR, constant cost per pixel (sigma >= 0.5)
+//   FFT       - reflect-padded full-image transform, cost grows with image size only
+// All three use BORDER_REFLECT_101 so they agree to within a small tolerance, and
+// switching backends at a cost threshold does not change the edges.
+class GaussianEngine {
+public:
+    enum Backend { AUTO, SPATIAL, RECURSIVE, FFT };
+
+    // sigmaY <= 0 means sigmaY = sigmaX. Output has the depth of the input.
+    static cv::Mat blur(const cv::Mat& input, double sigmaX, double sigmaY = 0,
+                        Backend backend = AUTO, Backend* chosen = nullptr);
+
+    // Cheapest backend according to the calibrated cost model (logged at INFO level
+    // the first time each size, sigma and backend combination is decided)
+    static Backend choose(cv::Size size, int channels, double sigmaX, double sigmaY);
+
+    // Spatial sigma equivalent to a centred frequency-domain Gaussian of cutoff D0
+    // on an axis of the given length: sigma = N / (2 * pi * D0)
+    static double sigmaFromCutoff(int length, float D0);
+
+    static const char* backendName(Backend backend);
+
+private:
+    struct Costs { double spatial, recursive, fft; };
+    static const Costs& calibratedCosts();
+
+    static int radiusFor(double sigma);
+    static cv::Mat blurSpatial(const cv::Mat& src32f, double sigmaX, double sigmaY);
+    static cv::Mat blurRecursive(const cv::Mat& src32f, double sigmaX, double sigmaY);
+    static cv::Mat blurFFT(const cv::Mat& src32f, double sigmaX, double sigmaY);
+};
+
+#endif // GAUSSIANENGINE_H
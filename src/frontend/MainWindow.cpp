@@ -348,12 +348,20 @@ void MainWindow::updateLayoutForTask(int taskIndex) {
     if (inputPanels.size() >= 2 && !inputPanels[1]->getImage().empty()) {
         savedInput2 = inputPanels[1]->getImage().clone();
     }
+    cv::Mat savedInput3;
+    if (inputPanels.size() >= 3 && !inputPanels[2]->getImage().empty()) {
+        savedInput3 = inputPanels[2]->getImage().clone();
+    }
 
     // Rebuild panels per task requirements
     if (taskIndex == 3) {
         rebuildPanels(1, 3,
             {"Source Image"},
             {"X Gradient", "Y Gradient", "Magnitude"});
+    } else if (taskIndex == 2) {
+        rebuildPanels(3, 1, {"Source Image", "Guide (optional)", "Clean Reference (optional)"}, {"Processed Output"});
+    } else if (taskIndex == 6) {
+        rebuildPanels(2, 1, {"Source Image", "Reference (for matching)"}, {"Processed Output"});
     } else if (taskIndex == 8) {
         rebuildPanels(1, 4,
             {"Source RGB Image"},
@@ -363,9 +371,9 @@ void MainWindow::updateLayoutForTask(int taskIndex) {
             {"Image A  (Low Freq)", "Image B  (High Freq)"},
             {"Hybrid Result"});
     } else if (taskIndex == 9) {
-        rebuildPanels(1, 1, {"Source Image"}, {"Filtered Result"});
+        rebuildPanels(1, 2, {"Source Image"}, {"Filtered Result", "Log Spectrum · Mask"});
     } else if (taskIndex == 7) {
-        rebuildPanels(1, 1, {"Source Image"}, {"Pixel Distribution"});
+        rebuildPanels(1, 2, {"Source Image"}, {"Pixel Distribution", "Local Entropy Map"});
         infoSidebar->show();
         infoSidebar->setHtml(R"(
             <style>
@@ -394,6 +402,9 @@ void MainWindow::updateLayoutForTask(int taskIndex) {
     if (!savedInput2.empty() && inputPanels.size() >= 2) {
         inputPanels[1]->displayImage(savedInput2);
     }
+    if (!savedInput3.empty() && inputPanels.size() >= 3) {
+        inputPanels[2]->displayImage(savedInput3);
+    }
 }
 
 void MainWindow::rebuildPanels(int numInputs, int numOutputs,
@@ -418,6 +429,11 @@ void MainWindow::rebuildPanels(int numInputs, int numOutputs,
         ImagePanel* panel = new ImagePanel(title, true, leftSplitter);
         leftSplitter->addWidget(panel);
         panel->show();
+        if (i == 0) {
+            panel->setRegionSelectable(true);
+            connect(panel, &ImagePanel::regionSelected, this, &MainWindow::regionSelected);
+            connect(panel, &ImagePanel::imageLoaded, this, &MainWindow::sourceImageLoaded);
+        }
         inputPanels.append(panel);
     }
 
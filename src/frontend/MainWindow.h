@@ -35,6 +35,12 @@ public:
     void updateLayoutForTask(int taskIndex);
     void setStatusMessage(const QString& msg, bool success = true);
 
+signals:
+    // Forwarded from the source panel (first input) when a region is dragged
+    void regionSelected(const cv::Rect& region);
+    // A new image was loaded into the source panel
+    void sourceImageLoaded();
+
 private:
     // UI regions
     QWidget* leftRail;           // Sidebar navigation
@@ -12,6 +12,8 @@
 #include <QSizePolicy>
 #include <QGraphicsDropShadowEffect>
 #include <QTimer>
+#include <QMouseEvent>
+#include <algorithm>
 
 ImagePanel::ImagePanel(const QString& title, bool isInput, QWidget *parent)
     : QWidget(parent), isInput(isInput), titleText(title)
@@ -163,16 +165,29 @@ ImagePanel::ImagePanel(const QString& title, bool isInput, QWidget *parent)
 }
 
 cv::Mat ImagePanel::getImage() const { return currentImage; }
+QString ImagePanel::getTitle() const { return titleText; }
 
 void ImagePanel::setTitle(const QString& title) {
     titleText = title;
     titleLabel->setText(title.toUpper());
 }
 
+void ImagePanel::setRegionSelectable(bool selectable) {
+    if (selectable == regionSelectable) return;
+    regionSelectable = selectable;
+    if (selectable) {
+        imageDisplay->installEventFilter(this);
+    } else {
+        imageDisplay->removeEventFilter(this);
+        if (selectionBand) selectionBand->hide();
+    }
+}
+
 void ImagePanel::displayImage(const cv::Mat& img) {
     if (img.empty()) return;
     currentImage = img.clone();
     currentPixmap = cvMatToPixmap(currentImage);
+    if (selectionBand) selectionBand->hide();
 
     imageDisplay->setStyleSheet(
         "background-color: #F0EEF9;"
@@ -222,10 +237,11 @@ QString ImagePanel::formatImageSize(const cv::Mat& img) {
 }
 
 QString ImagePanel::getChannelInfo(const cv::Mat& img) {
-    if (img.channels() == 1) return "Grayscale";
-    if (img.channels() == 3) return "RGB";
-    if (img.channels() == 4) return "RGBA";
-    return QString("%1ch").arg(img.channels());
+    QString depth = (img.depth() == CV_16U) ? " · 16-bit" : "";
+    if (img.channels() == 1) return "Grayscale" + depth;
+    if (img.channels() == 3) return "RGB" + depth;
+    if (img.channels() == 4) return "RGBA" + depth;
+    return QString("%1ch").arg(img.channels()) + depth;
 }
 
 void ImagePanel::resizeEvent(QResizeEvent *event) {
@@ -252,7 +268,7 @@ void ImagePanel::dropEvent(QDropEvent* event) {
     QList<QUrl> urls = event->mimeData()->urls();
     if (!urls.isEmpty()) {
         QString path = urls.first().toLocalFile();
-        cv::Mat img = cv::imread(path.toStdString());
+        cv::Mat img = loadImage(path);
         if (!img.empty()) displayImage(img);
     }
     if (currentImage.empty()) {
@@ -263,6 +279,47 @@ void ImagePanel::dropEvent(QDropEvent* event) {
     }
 }
 
+// Drag on a loaded image to select a region; the band follows the mouse and the
+// region is re-emitted on every move so statistics can update live
+bool ImagePanel::eventFilter(QObject* watched, QEvent* event) {
+    if (watched != imageDisplay || currentImage.empty())
+        return QWidget::eventFilter(watched, event);
+
+    auto* mouse = dynamic_cast<QMouseEvent*>(event);
+    if (!mouse) return QWidget::eventFilter(watched, event);
+
+    if (event->type() == QEvent::MouseButtonPress && mouse->button() == Qt::LeftButton) {
+        if (!selectionBand) selectionBand = new QRubberBand(QRubberBand::Rectangle, imageDisplay);
+        selectionOrigin = mouse->pos();
+        selectionBand->setGeometry(QRect(selectionOrigin, QSize()));
+        selectionBand->show();
+        return true;
+    }
+    if ((event->type() == QEvent::MouseMove || event->type() == QEvent::MouseButtonRelease)
+        && selectionBand && selectionBand->isVisible()) {
+        selectionBand->setGeometry(QRect(selectionOrigin, mouse->pos()).normalized());
+        cv::Point a = toImagePoint(selectionOrigin), b = toImagePoint(mouse->pos());
+        cv::Rect region(cv::Point(std::min(a.x, b.x), std::min(a.y, b.y)),
+                        cv::Point(std::max(a.x, b.x) + 1, std::max(a.y, b.y) + 1));
+        emit regionSelected(region);
+        if (event->type() == QEvent::MouseButtonRelease && region.area() <= 1) selectionBand->hide();
+        return true;
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+// Maps a position on imageDisplay to image pixels; the pixmap is scaled to fit
+// and centred in the label
+cv::Point ImagePanel::toImagePoint(const QPoint& displayPos) const {
+    const QPixmap* shown = imageDisplay->pixmap();
+    if (!shown || shown->isNull() || currentImage.empty()) return cv::Point();
+    QPoint offset((imageDisplay->width() - shown->width()) / 2, (imageDisplay->height() - shown->height()) / 2);
+    QPoint p = displayPos - offset;
+    int x = (int)((double)p.x() * currentImage.cols / shown->width());
+    int y = (int)((double)p.y() * currentImage.rows / shown->height());
+    return cv::Point(std::clamp(x, 0, currentImage.cols - 1), std::clamp(y, 0, currentImage.rows - 1));
+}
+
 void ImagePanel::enterEvent(QEvent* event) {
     QWidget::enterEvent(event);
 }
@@ -273,6 +330,7 @@ void ImagePanel::leaveEvent(QEvent* event) {
 
 void ImagePanel::clear() {
     currentImage = cv::Mat();
+    if (selectionBand) selectionBand->hide();
     currentPixmap = QPixmap();
     imageDisplay->clear();
     imageDisplay->setStyleSheet(
@@ -298,13 +356,27 @@ void ImagePanel::handleLoadImage() {
         "Images (*.png *.jpg *.jpeg *.bmp *.tiff *.tif *.webp);;All Files (*)"
     );
     if (!fileName.isEmpty()) {
-        cv::Mat img = cv::imread(fileName.toStdString());
+        cv::Mat img = loadImage(fileName);
         if (!img.empty()) displayImage(img);
     }
 }
 
-QPixmap ImagePanel::cvMatToPixmap(const cv::Mat& img) {
-    if (img.empty()) return QPixmap();
+// 16-bit files keep their depth (the backend works on them natively); anything
+// else that is not 8-bit, e.g. float TIFF, is stretched into 16 bits
+cv::Mat ImagePanel::loadImage(const QString& path) {
+    cv::Mat img = cv::imread(path.toStdString(), cv::IMREAD_ANYDEPTH | cv::IMREAD_COLOR);
+    if (!img.empty() && img.depth() != CV_8U && img.depth() != CV_16U)
+        cv::normalize(img, img, 0, 65535, cv::NORM_MINMAX, CV_16U);
+    return img;
+}
+
+QPixmap ImagePanel::cvMatToPixmap(const cv::Mat& src) {
+    if (src.empty()) return QPixmap();
+    // Only the on-screen copy is reduced to 8 bits; currentImage keeps its depth
+    cv::Mat img = src;
+    if (src.depth() == CV_16U) src.convertTo(img, CV_8U, 1.0 / 257.0);
+    else if (src.depth() != CV_8U) cv::normalize(src, img, 0, 255, cv::NORM_MINMAX, CV_8U);
+
     cv::Mat temp;
     if (img.channels() == 3) {
         cv::cvtColor(img, temp, cv::COLOR_BGR2RGB);
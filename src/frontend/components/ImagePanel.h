@@ -13,6 +13,7 @@
 #include <QMimeData>
 #include <QPropertyAnimation>
 #include <QGraphicsOpacityEffect>
+#include <QRubberBand>
 #include <opencv2/opencv.hpp>
 
 class ImagePanel : public QWidget {
@@ -22,12 +23,18 @@ public:
     explicit ImagePanel(const QString& title, bool isInput, QWidget *parent = nullptr);
 
     cv::Mat getImage() const;
+    QString getTitle() const;
     void displayImage(const cv::Mat& img);
     void clear();
     void setTitle(const QString& title);
+    // Lets a rectangle be dragged over the image, reported through regionSelected;
+    // off by default so panels nobody listens to keep plain mouse behaviour
+    void setRegionSelectable(bool selectable);
 
 signals:
     void imageLoaded(const cv::Mat& img);
+    // Rectangle dragged over the image, in image pixels; emitted while dragging
+    void regionSelected(const cv::Rect& region);
 
 protected:
     void resizeEvent(QResizeEvent *event) override;
@@ -35,6 +42,7 @@ protected:
     void dropEvent(QDropEvent* event) override;
     void enterEvent(QEvent* event) override;
     void leaveEvent(QEvent* event) override;
+    bool eventFilter(QObject* watched, QEvent* event) override;
 
 private slots:
     void handleLoadImage();
@@ -55,6 +63,9 @@ private:
     QWidget* footerWidget;
     QLabel* channelInfo;
     QLabel* pixelCount;
+    QRubberBand* selectionBand = nullptr;
+    bool regionSelectable = false;
+    QPoint selectionOrigin;
 
     cv::Mat currentImage;
     QPixmap currentPixmap;
@@ -62,11 +73,13 @@ private:
     QString titleText;
 
     QPixmap cvMatToPixmap(const cv::Mat& img);
+    cv::Mat loadImage(const QString& path);
     void updateDisplay();
     void updateFooterInfo();
     void setOverlayVisible(bool visible);
     QString formatImageSize(const cv::Mat& img);
     QString getChannelInfo(const cv::Mat& img);
+    cv::Point toImagePoint(const QPoint& displayPos) const;
 };
 
 #endif
@@ -103,6 +103,40 @@ QWidget* ParameterBox::buildLabeledSpin(const QString& label, const QString& obj
     return container;
 }
 
+QWidget* ParameterBox::buildLabeledDoubleSpin(const QString& label, const QString& objName,
+                                               double min, double max, double step, double value) {
+    QWidget* container = new QWidget(this);
+    QHBoxLayout* cl = new QHBoxLayout(container);
+    cl->setContentsMargins(0, 0, 0, 0);
+    cl->setSpacing(8);
+
+    QLabel* lbl = new QLabel(label, container);
+    lbl->setObjectName("paramLabel");
+    lbl->setFixedWidth(label.length() * 7 + 4);
+
+    QDoubleSpinBox* spin = new QDoubleSpinBox(container);
+    spin->setObjectName(objName);
+    spin->setRange(min, max);
+    spin->setSingleStep(step);
+    spin->setDecimals(2);
+    spin->setValue(value);
+    spin->setFixedWidth(80);
+
+    cl->addWidget(lbl);
+    cl->addWidget(spin);
+    return container;
+}
+
+// Shared by the statistics tasks (4, 5 and 7)
+QWidget* ParameterBox::buildStatsModeCombo() {
+    return buildLabeledCombo(
+        "Statistics", "statsModeCombo",
+        {"Progressive", "Exact"},
+        "Progressive: images over 8 MP show sampled statistics with error bounds at once,"
+        " then refine to exact in the background  |  Exact: always scan every pixel"
+    );
+}
+
 void ParameterBox::updateParametersForTask(int taskIndex) {
     clearLayout();
 
@@ -110,11 +144,15 @@ void ParameterBox::updateParametersForTask(int taskIndex) {
         case 0: { // Task 1: Add Noise
             layout->addWidget(buildLabeledCombo(
                 "Type", "noiseTypeCombo",
-                {"Uniform", "Gaussian", "Salt & Pepper"},
-                "Uniform: flat random  |  Gaussian: bell-curve (ISO simulation)  |  Salt & Pepper: dead pixels"
+                {"Uniform", "Zero-mean Uniform", "Gaussian", "Salt & Pepper", "Batch Export"},
+                "Uniform: flat random  |  Zero-mean Uniform: flat random, keeps brightness"
+                "  |  Gaussian: bell-curve (ISO simulation)  |  Salt & Pepper: dead pixels"
+                "  |  Batch Export: many (type, intensity, seed) variants written to a folder"
             ));
             layout->addWidget(buildSeparator());
             layout->addWidget(buildLabeledSlider("Intensity", "noiseIntensitySlider", 0, 100, 20));
+            layout->addWidget(buildSeparator());
+            layout->addWidget(buildLabeledSpin("Seed", "noiseSeedSpin", 0, 999999, 1, 0));
 
             // Dynamic tooltip hint
             QLabel* hint = new QLabel("", this);
@@ -125,7 +163,9 @@ void ParameterBox::updateParametersForTask(int taskIndex) {
             if (combo) {
                 auto updateHint = [hint](const QString& t) {
                     if (t == "Uniform") hint->setText("Adds uniform random noise");
+                    else if (t == "Zero-mean Uniform") hint->setText("Adds ± intensity / 2");
                     else if (t == "Gaussian") hint->setText("σ = intensity / 2");
+                    else if (t == "Batch Export") hint->setText("Asks for a variant list and a folder");
                     else hint->setText("fraction = intensity / 100");
                 };
                 QObject::connect(combo, &QComboBox::currentTextChanged, updateHint);
@@ -138,14 +178,47 @@ void ParameterBox::updateParametersForTask(int taskIndex) {
         case 1: { // Task 2: Low Pass Filters
             layout->addWidget(buildLabeledCombo(
                 "Filter", "filterTypeCombo",
-                {"Average", "Gaussian", "Median"},
+                {"Average", "Gaussian", "Median", "Adaptive Median", "Guided", "Recursive Gaussian", "Disk Blur", "Autotune"},
                 "Average: mean of neighborhood  |  Gaussian: weighted center-biased  |  Median: best for salt & pepper"
+                "  |  Adaptive Median: fixes impulses only, kernel = max window"
+                "  |  Guided: edge-preserving, optional guide image  |  Recursive Gaussian: IIR, same cost for any sigma"
+                "  |  Disk Blur: lens-style circular kernel, FFT tiles for large sizes"
+                "  |  Autotune: time vs quality sweep over kernels 3-15"
             ));
             layout->addWidget(buildSeparator());
-            layout->addWidget(buildLabeledSpin("Kernel", "kernelSizeSpin", 3, 31, 2, 3));
+            QWidget* kernelBox  = buildLabeledSpin("Kernel", "kernelSizeSpin", 3, 255, 2, 3);
+            QWidget* sigmaBox   = buildLabeledSpin("Sigma", "sigmaSpin", 1, 500, 1, 20);
+            QWidget* qualityBox = buildLabeledCombo(
+                "Quality", "qualityCombo", {"Full", "Fast Preview"},
+                "Full: exact filter  |  Fast Preview: stacked boxes (Gaussian), 1/4-res model (Guided)"
+            );
+            QWidget* epsBox     = buildLabeledSlider("Edge ε", "guidedEpsSlider", 1, 100, 10);
+            epsBox->setToolTip("Edges with local contrast above ε% of full range are preserved");
+            layout->addWidget(kernelBox);
+            layout->addWidget(sigmaBox);
+            layout->addWidget(qualityBox);
+            layout->addWidget(epsBox);
 
-            QLabel* hint = new QLabel("Larger kernel → stronger blur", this);
+            QLabel* hint = new QLabel("", this);
             hint->setStyleSheet("font-size: 10px; color: #B8B0A6; font-style: italic;");
+
+            // Recursive Gaussian is driven by sigma, the others by kernel size;
+            // Gaussian and Guided have a preview mode, Guided an edge threshold
+            auto* combo = this->findChild<QComboBox*>("filterTypeCombo");
+            if (combo) {
+                auto updateControls = [kernelBox, sigmaBox, qualityBox, epsBox, hint](const QString& t) {
+                    bool recursive = (t == "Recursive Gaussian");
+                    bool autotune = (t == "Autotune");
+                    kernelBox->setVisible(!recursive && !autotune);
+                    sigmaBox->setVisible(recursive);
+                    qualityBox->setVisible(t == "Gaussian" || t == "Guided");
+                    epsBox->setVisible(t == "Guided");
+                    hint->setText(autotune  ? "Sweeps Average, Gaussian and Median at kernels 3-15"
+                                : recursive ? "Larger sigma → stronger blur" : "Larger kernel → stronger blur");
+                };
+                QObject::connect(combo, &QComboBox::currentTextChanged, updateControls);
+                updateControls(combo->currentText());
+            }
             layout->addWidget(hint);
             layout->addStretch();
             break;
@@ -163,15 +236,60 @@ void ParameterBox::updateParametersForTask(int taskIndex) {
             layout->addStretch();
             break;
         }
+        case 3: { // Task 4: Histogram
+            layout->addWidget(buildStatsModeCombo());
+            layout->addStretch();
+            break;
+        }
+        case 4: { // Task 5: Normalization
+            layout->addWidget(buildLabeledCombo(
+                "Stretch", "normModeCombo",
+                {"Min / Max", "Percentile"},
+                "Min / Max: full range of each channel  |  Percentile: clip the darkest and brightest pixels first"
+            ));
+            QWidget* clipBox = buildLabeledDoubleSpin("Clip %", "clipPercentSpin", 0.0, 20.0, 0.5, 1.0);
+            layout->addWidget(clipBox);
+            layout->addWidget(buildSeparator());
+            layout->addWidget(buildLabeledDoubleSpin("Gamma", "gammaSpin", 0.1, 5.0, 0.1, 1.0));
+
+            auto* combo = this->findChild<QComboBox*>("normModeCombo");
+            if (combo) {
+                auto updateClip = [clipBox](const QString& t) { clipBox->setVisible(t == "Percentile"); };
+                QObject::connect(combo, &QComboBox::currentTextChanged, updateClip);
+                updateClip(combo->currentText());
+            }
+
+            QLabel* hint = new QLabel("Folded with the stretch into one LUT pass · > 1 brightens mid-tones", this);
+            hint->setStyleSheet("font-size: 10px; color: #B8B0A6; font-style: italic;");
+            layout->addWidget(hint);
+            layout->addWidget(buildSeparator());
+            layout->addWidget(buildStatsModeCombo());
+            layout->addStretch();
+            break;
+        }
         case 5: { // Task 6: Equalization
             layout->addWidget(buildLabeledCombo(
                 "Mode", "eqModeCombo",
-                {"Grayscale Equalization", "RGB Equalization"},
+                {"Grayscale Equalization", "RGB Equalization", "Adaptive (CLAHE)",
+                 "Match Reference (Luma)", "Match Reference (Per Channel)", "Match Reference · Batch"},
                 "Grayscale: luminance CDF mapping  |  RGB: per-channel equalization (may shift hues)"
+                "  |  Adaptive: tile-local, contrast-limited (uneven lighting)"
+                "  |  Match: take the histogram of the reference panel (Batch: many files, one reference)"
             ));
             layout->addStretch();
             break;
         }
+        case 6: { // Task 7: Entropy
+            layout->addWidget(buildLabeledSpin("Window", "entropyWindowSpin", 3, 99, 2, 9));
+            layout->addWidget(buildSeparator());
+            layout->addWidget(buildStatsModeCombo());
+
+            QLabel* hint = new QLabel("Local entropy map: sliding window, cost grows with its width", this);
+            hint->setStyleSheet("font-size: 10px; color: #B8B0A6; font-style: italic;");
+            layout->addWidget(hint);
+            layout->addStretch();
+            break;
+        }
         case 8: { // Task 9: Frequency Filters
             layout->addWidget(buildLabeledCombo(
                 "Type", "freqTypeCombo",
@@ -179,12 +297,34 @@ void ParameterBox::updateParametersForTask(int taskIndex) {
                 "Low pass: smoothing/blur  |  High pass: edge extraction"
             ));
 
+            layout->addWidget(buildSeparator());
+            layout->addWidget(buildLabeledCombo(
+                "Color", "colorModeCombo",
+                {"Grayscale", "Color (BGR)", "Color (Luma)"},
+                "Grayscale: single plane  |  BGR: 3 FFTs in parallel  |  Luma: filters Y only, keeps chroma"
+            ));
+            layout->addWidget(buildSeparator());
+            layout->addWidget(buildLabeledCombo(
+                "Spectrum", "spectrumCombo",
+                {"Show", "Hide"},
+                "Show: log-magnitude spectrum with the mask, from the filter's own DFT  |  Hide: lets small kernels skip the DFT"
+            ));
+
             QLabel* hint = new QLabel("Gaussian Fourier filter  ·  D₀ = 50", this);
             hint->setStyleSheet("font-size: 10px; color: #B8B0A6; font-style: italic;");
             layout->addWidget(hint);
             layout->addStretch();
             break;
         }
+        case 9: { // Task 10: Hybrid Images
+            layout->addWidget(buildLabeledCombo(
+                "Color", "colorModeCombo",
+                {"Grayscale", "Color (BGR)", "Color (Luma)"},
+                "Grayscale: single plane  |  BGR: 3 FFTs in parallel  |  Luma: filters Y only, keeps chroma of Image A"
+            ));
+            layout->addStretch();
+            break;
+        }
         default: {
             QLabel* hint = new QLabel("No parameters required", this);
             hint->setStyleSheet("font-size: 12px; color: #C4BDB4; font-style: italic;");
@@ -7,6 +7,7 @@
 #include <QComboBox>
 #include <QSlider>
 #include <QSpinBox>
+#include <QDoubleSpinBox>
 #include <QFrame>
 
 class ParameterBox : public QWidget {
@@ -29,7 +30,10 @@ private:
                                  int min, int max, int value);
     QWidget* buildLabeledSpin(const QString& label, const QString& objName,
                                int min, int max, int step, int value);
+    QWidget* buildLabeledDoubleSpin(const QString& label, const QString& objName,
+                                     double min, double max, double step, double value);
     QFrame* buildSeparator();
+    QWidget* buildStatsModeCombo();
 };
 
 #endif // PARAMETERBOX_H
@@ -3,22 +3,53 @@
 #include "../components/TopTaskBar.h"
 #include "../components/ImagePanel.h"
 #include "../../backend/Module1_NoiseAndFilters/NoiseGenerator.h"
+#include "../../backend/Module1_NoiseAndFilters/NoiseBatch.h"
+#include "../../backend/Module1_NoiseAndFilters/FilterAutotuner.h"
 #include "../../backend/Module1_NoiseAndFilters/LowPassFilters.h"
 #include "../../backend/Module2_EdgesAndEntropy/EdgeDetectors.h"
 #include "../../backend/Module2_EdgesAndEntropy/EntropyCalculator.h"
+#include "../../backend/Module2_EdgesAndEntropy/QualityMetrics.h"
 #include "../../backend/Module3_HistogramsAndColor/HistogramTools.h"
 #include "../../backend/Module3_HistogramsAndColor/ColorTransformations.h"
+#include "../../backend/Module3_HistogramsAndColor/SampledStatistics.h"
 #include "../../backend/Module4_Enhancement/ImageEqualizer.h"
+#include "../../backend/Module4_Enhancement/HistogramMatcher.h"
 #include "../../backend/Module4_Enhancement/ImageNormalizer.h"
+#include "../../backend/Module4_Enhancement/PointOpChain.h"
 #include "../../backend/Module5_FrequencyAndHybrid/HybridImageBuilder.h"
 #include "../../backend/Module5_FrequencyAndHybrid/FrequencyFilters.h"
 
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QInputDialog>
 #include <QMessageBox>
 #include <QComboBox>
 #include <QSlider>
 #include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QTextBrowser>
+#include <QPointer>
+#include <QtConcurrent/QtConcurrent>
+#include <cmath>
+
+namespace {
+
+// Progressive statistics (Tasks 4, 5 and 7) take over from this many pixels and
+// preview from a sample of about SAMPLE_TARGET pixels
+const double SAMPLING_MIN_PIXELS = 8e6;
+const uint64_t SAMPLE_TARGET = 1 << 20;
+// Longest side of a sampled Task 5 preview, about what a panel can show
+const int PREVIEW_MAX_SIDE = 1600;
+const char* APPROX_SUFFIX = " · ≈ approx";
+
+// Status chip note for a sampled result: sample size and the DKW bound on its CDF
+QString approxNote(const cv::Mat& sample) {
+    return QString(" · ≈ %1 samples · CDF ±%2%")
+        .arg((qulonglong)sample.total())
+        .arg(100.0 * SampledStatistics::dkwEpsilon(sample.total()), 0, 'f', 2);
+}
+
+} // namespace
 
 AppController::AppController(MainWindow* window, QObject *parent)
     : QObject(parent), mainWindow(window) {
@@ -26,10 +57,60 @@ AppController::AppController(MainWindow* window, QObject *parent)
     connect(mainWindow->getTopTaskBar(), &TopTaskBar::applyRequested, this, &AppController::handleApply);
     connect(mainWindow->getTopTaskBar(), &TopTaskBar::clearRequested, this, &AppController::handleClear);
     connect(mainWindow->getTopTaskBar(), &TopTaskBar::saveRequested,  this, &AppController::handleSave);
+    connect(mainWindow, &MainWindow::regionSelected, this, &AppController::handleRegionSelected);
+    connect(mainWindow, &MainWindow::sourceImageLoaded, this, [this]() {
+        // A freed image's address can be reused, so a fresh load always re-indexes
+        indexedData = nullptr;
+        regionIndex.reset();
+        prepareRegionIndex();
+    });
+
+    connect(&batchPoll, &QTimer::timeout, this, [this]() {
+        mainWindow->setStatusMessage(QString("%1 %2/%3…").arg(batchVerb).arg(batchDone->load()).arg(batchTotal), true);
+    });
+    connect(&refineWatcher, &QFutureWatcher<RefineResult>::finished, this, [this]() {
+        // Dropped if another apply, task, clear or image has replaced the preview
+        RefineResult result = refineWatcher.result();
+        auto& inputs = mainWindow->getInputPanels();
+        bool current = !*refineCancel && !inputs.isEmpty() && inputs[0]->getImage().data == refineSource.data;
+        refineSource.release();
+        if (current && result.first) {
+            result.first();
+            mainWindow->setStatusMessage(QString("Exact ✓ · %1 ms").arg(result.second, 0, 'f', 1), true);
+        }
+        startPendingRefine();
+    });
+    connect(&indexWatcher, &QFutureWatcher<IndexResult>::finished, this, [this]() {
+        IndexResult result = indexWatcher.result();
+        // The source changed while building: index the current one instead
+        if (indexJobData != indexedData) { prepareRegionIndex(); return; }
+        regionIndex = result.first;
+        int taskIndex = mainWindow->getTopTaskBar()->getSelectedOperation();
+        if (taskIndex == 4 || taskIndex == 7)
+            mainWindow->setStatusMessage(QString("Region index ready · %1 ms").arg(result.second, 0, 'f', 1), true);
+    });
+    connect(&batchWatcher, &QFutureWatcher<BatchResult>::finished, this, [this]() {
+        batchPoll.stop();
+        BatchResult result = batchWatcher.result();
+        mainWindow->getTopTaskBar()->setProcessing(false);
+        mainWindow->setStatusMessage(result.first, result.second);
+        std::function<void()> then = batchThen;
+        batchThen = nullptr;
+        if (then) then();
+    });
+}
+
+AppController::~AppController() {
+    cancelRefinement();
+    refineWatcher.waitForFinished();
+    batchWatcher.waitForFinished();
+    indexWatcher.waitForFinished();
 }
 
 void AppController::handleTaskChange(int taskIndex) {
+    cancelRefinement();
     mainWindow->updateLayoutForTask(taskIndex);
+    prepareRegionIndex();
 }
 
 void AppController::handleApply() {
@@ -45,39 +126,161 @@ void AppController::handleApply() {
     mainWindow->getTopTaskBar()->setProcessing(true);
     cv::Mat currentImg = inputs[0]->getImage();
     ParameterBox* pBox = mainWindow->getTopTaskBar()->getParameterBox();
+    QString timing;      // optional " · N ms" suffix for the status chip
+    QString approximate; // approxNote() of a sampled preview, empty when exact
+
+    // Anything still refining from an earlier apply is superseded
+    cancelRefinement();
+    for (auto* panel : outputs) markApproximate(panel, false);
+
+    // Shared by the frequency tasks (9 and 10)
+    auto selectedColorMode = [pBox]() {
+        QComboBox* colorCombo = pBox->findChild<QComboBox*>("colorModeCombo");
+        QString mode = colorCombo ? colorCombo->currentText() : QString();
+        if (mode == "Color (BGR)")  return FrequencyFilters::COLOR_BGR;
+        if (mode == "Color (Luma)") return FrequencyFilters::COLOR_LUMA;
+        return FrequencyFilters::GRAYSCALE;
+    };
 
     // ── TASK 1: ADD NOISE ─────────────────────────────────
     if (taskIndex == 1) {
         QComboBox* combo  = pBox->findChild<QComboBox*>("noiseTypeCombo");
         QSlider*   slider = pBox->findChild<QSlider*>("noiseIntensitySlider");
+        QSpinBox*  seedSpin = pBox->findChild<QSpinBox*>("noiseSeedSpin");
         if (!combo || !slider) { mainWindow->getTopTaskBar()->setProcessing(false); return; }
 
         QString item = combo->currentText();
         int intensity = slider->value();
+        uint64_t seed = seedSpin ? (uint64_t)seedSpin->value() : 0;
         cv::Mat result;
 
-        if      (item == "Uniform")       result = NoiseGenerator::addUniformNoise(currentImg, intensity);
-        else if (item == "Gaussian")      result = NoiseGenerator::addGaussianNoise(currentImg, intensity / 2.0);
-        else if (item == "Salt & Pepper") result = NoiseGenerator::addSaltPepperNoise(currentImg, intensity / 100.0);
+        if (item == "Batch Export") {
+            QString defaults;
+            for (int i = 0; i < 4; i++)
+                defaults += QString("gaussian %1 %2\n").arg(intensity).arg(seed + i);
+
+            bool ok = false;
+            QString text = QInputDialog::getMultiLineText(
+                mainWindow, "Batch Noise Export",
+                "One variant per line: <type> <intensity> <seed>\n"
+                "Types: uniform, zero-mean, gaussian, salt-pepper",
+                defaults, &ok);
+            std::vector<NoiseBatch::Spec> specs;
+            std::string error;
+            if (ok && (!NoiseBatch::parseSpecs(text.toStdString(), specs, &error) || specs.empty())) {
+                QMessageBox::warning(mainWindow, "Batch Noise Export",
+                    error.empty() ? QString("No variants given.") : QString::fromStdString(error));
+                ok = false;
+            }
+            // PNG is compact; binary PNM skips compression, which is what limits
+            // the export rate
+            QString formatName = ok ? QInputDialog::getItem(mainWindow, "Batch Noise Export", "Format",
+                                                            {"PNG (compressed)", "PNM (uncompressed, fastest)"},
+                                                            0, false, &ok)
+                                    : QString();
+            NoiseBatch::Format format = formatName.startsWith("PNM") ? NoiseBatch::PNM : NoiseBatch::PNG;
+            QString dir = ok ? QFileDialog::getExistingDirectory(mainWindow, "Export Variants To") : QString();
+            if (dir.isEmpty()) {
+                mainWindow->getTopTaskBar()->setProcessing(false);
+                mainWindow->setStatusMessage("Batch cancelled", false);
+                return;
+            }
+
+            if (!outputs.isEmpty()) outputs[0]->displayImage(NoiseBatch::generate(currentImg, specs[0]));
+
+            std::string directory = dir.toStdString();
+            runBatch("Exporting", (int)specs.size(), [currentImg, specs, directory, format](std::atomic<int>& done) {
+                NoiseBatch::Timing timing;
+                int written = NoiseBatch::exportVariants(currentImg, specs, directory, "noisy", &timing, &done, format);
+                double rate = written * 1000.0 / std::max(timing.elapsedMs, 1e-3);
+                // Megapixels per second compare across image sizes; the
+                // generation-only rate shows how much encoding costs
+                QString msg = QString("Exported %1/%2 · %3 ms · %4 img/s · %5 MP/s · noise alone %6 img/s")
+                                  .arg(written).arg(specs.size()).arg(timing.elapsedMs, 0, 'f', 1)
+                                  .arg(rate, 0, 'f', 0).arg(rate * currentImg.total() / 1e6, 0, 'f', 0)
+                                  .arg(timing.generateRate, 0, 'f', 0);
+                return BatchResult(msg, written == (int)specs.size());
+            });
+            return;
+        }
+
+        if      (item == "Uniform")       result = NoiseGenerator::addUniformNoise(currentImg, intensity, seed);
+        else if (item == "Zero-mean Uniform") result = NoiseGenerator::addZeroMeanUniformNoise(currentImg, intensity, seed);
+        else if (item == "Gaussian")      result = NoiseGenerator::addGaussianNoise(currentImg, intensity / 2.0, seed);
+        else if (item == "Salt & Pepper") result = NoiseGenerator::addSaltPepperNoise(currentImg, intensity / 100.0, seed);
 
         if (!outputs.isEmpty()) outputs[0]->displayImage(result);
+        showQualityMetrics(result, cv::Mat());
     }
 
     // ── TASK 2: LOW PASS FILTERS ──────────────────────────
     else if (taskIndex == 2) {
         QComboBox* combo = pBox->findChild<QComboBox*>("filterTypeCombo");
         QSpinBox*  spin  = pBox->findChild<QSpinBox*>("kernelSizeSpin");
+        QSpinBox*  sigmaSpin = pBox->findChild<QSpinBox*>("sigmaSpin");
+        QComboBox* qualityCombo = pBox->findChild<QComboBox*>("qualityCombo");
+        QSlider*   epsSlider = pBox->findChild<QSlider*>("guidedEpsSlider");
+        bool preview = qualityCombo && qualityCombo->currentText() == "Fast Preview";
         if (!combo || !spin) { mainWindow->getTopTaskBar()->setProcessing(false); return; }
 
         QString item       = combo->currentText();
         int     kernelSize = spin->value();
         cv::Mat result;
 
+        if (item == "Autotune") {
+            // The reference panel holds the clean image when loaded, else the source is
+            cv::Mat reference = (inputs.size() >= 3 && !inputs[2]->getImage().empty())
+                                    ? inputs[2]->getImage() : currentImg;
+            // The sweep takes seconds on large images; the plot and the prompt
+            // follow once it finishes, if Task 2 is still on screen
+            auto report = std::make_shared<FilterAutotuner::Report>();
+            mainWindow->getInfoSidebar()->hide();
+            QPointer<QComboBox> comboRef(combo);
+            QPointer<QSpinBox> spinRef(spin);
+            runBatch("Autotuning", FilterAutotuner::trialCount(), [reference, report](std::atomic<int>& done) {
+                *report = FilterAutotuner::run(reference, 10.0, 15, 1, &done);
+                if (report->recommended < 0) return BatchResult("Autotune failed", false);
+                return BatchResult(QString("Autotuned %1 settings").arg(report->trials.size()), true);
+            }, [this, report, comboRef, spinRef]() {
+                auto& outputs = mainWindow->getOutputPanels();
+                if (mainWindow->getTopTaskBar()->getSelectedOperation() != 2 || !comboRef || !spinRef) return;
+                if (!outputs.isEmpty()) outputs[0]->displayImage(report->plot);
+                if (report->recommended < 0) return;
+
+                const FilterAutotuner::Trial& best = report->trials[report->recommended];
+                QString summary = QString("Recommended: %1, kernel %2\n%3 ms · PSNR %4 dB · SSIM %5\n\n"
+                                          "Apply this setting?")
+                                      .arg(QString::fromStdString(best.filter)).arg(best.kernelSize)
+                                      .arg(best.ms, 0, 'f', 1).arg(best.psnr, 0, 'f', 2).arg(best.ssim, 0, 'f', 4);
+                if (QMessageBox::question(mainWindow, "Filter Autotune", summary) == QMessageBox::Yes) {
+                    comboRef->setCurrentText(QString::fromStdString(best.filter));
+                    spinRef->setValue(best.kernelSize);
+                }
+            });
+            return;
+        }
+
         if      (item == "Average")  result = LowPassFilters::applyAverage(currentImg, kernelSize);
-        else if (item == "Gaussian") result = LowPassFilters::applyGaussian(currentImg, kernelSize);
+        else if (item == "Gaussian") result = LowPassFilters::applyGaussian(currentImg, kernelSize, preview);
         else if (item == "Median")   result = LowPassFilters::applyMedian(currentImg, kernelSize);
+        else if (item == "Adaptive Median") result = LowPassFilters::applyAdaptiveMedian(currentImg, kernelSize);
+        else if (item == "Guided") {
+            // Second input panel is an optional guide; eps slider is a contrast in %
+            cv::Mat guide = (inputs.size() >= 2) ? inputs[1]->getImage() : cv::Mat();
+            double edge = (epsSlider ? epsSlider->value() : 10) / 100.0;
+            result = LowPassFilters::applyGuided(currentImg, guide, kernelSize, edge * edge, preview);
+        }
+        else if (item == "Recursive Gaussian" && sigmaSpin)
+            result = LowPassFilters::applyRecursiveGaussian(currentImg, sigmaSpin->value());
+        else if (item == "Disk Blur") {
+            int64 start = cv::getTickCount();
+            result = LowPassFilters::applyDisk(currentImg, kernelSize);
+            timing = QString(" · %1 ms").arg((cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency(), 0, 'f', 1);
+        }
 
         if (!outputs.isEmpty()) outputs[0]->displayImage(result);
+        // Third input is the optional clean reference (the second is the guide)
+        showQualityMetrics(result, (inputs.size() >= 3) ? inputs[2]->getImage() : cv::Mat());
     }
 
     // ── TASK 3: EDGE DETECTION ────────────────────────────
@@ -109,26 +312,91 @@ void AppController::handleApply() {
 
     // ── TASK 4: HISTOGRAM ─────────────────────────────────
     else if (taskIndex == 4) {
-        cv::Mat grayImg;
-        if (currentImg.channels() > 1)
-            grayImg = ColorTransformations::convertToGray(currentImg);
-        else
-            grayImg = currentImg;
-
-        cv::Mat hist, cdf;
-        HistogramTools::getHistogramAndCDF(grayImg, hist, cdf);
-        cv::Mat plot = HistogramTools::plotHistogram(hist, cdf, cv::Scalar(155, 140, 230)); // violet
-
-        if (!outputs.isEmpty()) outputs[0]->displayImage(plot);
+        auto histogramPlot = [](const cv::Mat& image) {
+            cv::Mat grayImg;
+            if (image.channels() > 1)
+                grayImg = ColorTransformations::convertToGray(image);
+            else
+                grayImg = image;
+
+            cv::Mat hist, cdf;
+            HistogramTools::getHistogramAndCDF(grayImg, hist, cdf);
+            return HistogramTools::plotHistogram(hist, cdf, cv::Scalar(155, 140, 230)); // violet
+        };
+
+        if (useSampling(currentImg)) {
+            cv::Mat sample = SampledStatistics::sample(currentImg, SampledStatistics::strideFor(currentImg.size(), SAMPLE_TARGET));
+            if (!outputs.isEmpty()) {
+                outputs[0]->displayImage(histogramPlot(sample));
+                markApproximate(outputs[0], true);
+            }
+            approximate = approxNote(sample);
+
+            refineInBackground(currentImg, [this, currentImg, histogramPlot](const std::atomic<bool>& cancelled) {
+                cv::Mat plot = histogramPlot(currentImg);
+                if (cancelled) return std::function<void()>();
+                return std::function<void()>([this, plot]() {
+                    auto& outputs = mainWindow->getOutputPanels();
+                    if (outputs.isEmpty()) return;
+                    outputs[0]->displayImage(plot);
+                    markApproximate(outputs[0], false);
+                });
+            });
+        } else if (!outputs.isEmpty()) {
+            outputs[0]->displayImage(histogramPlot(currentImg));
+        }
     }
 
     // ── TASK 5: NORMALIZE ─────────────────────────────────
     else if (taskIndex == 5) {
-        ImageNormalizer normalizer;
-        cv::Mat normalizedFloat   = normalizer.normalize_image(currentImg);
-        cv::Mat normalizedDisplay;
-        normalizedFloat.convertTo(normalizedDisplay, CV_8U, 255.0);
-        if (!outputs.isEmpty()) outputs[0]->displayImage(normalizedDisplay);
+        QComboBox* modeCombo = pBox->findChild<QComboBox*>("normModeCombo");
+        QDoubleSpinBox* clipSpin = pBox->findChild<QDoubleSpinBox*>("clipPercentSpin");
+        QDoubleSpinBox* gammaSpin = pBox->findChild<QDoubleSpinBox*>("gammaSpin");
+        bool percentile = modeCombo && modeCombo->currentText() == "Percentile";
+        double clip = clipSpin ? clipSpin->value() : 1.0;
+        double gamma = gammaSpin ? gammaSpin->value() : 1.0;
+
+        // Stretch and gamma fold into one LUT, applied in a single pass; the
+        // stretch limits are read from `stats`, the image itself or a sample of it
+        auto buildChain = [percentile, clip, gamma](const cv::Mat& stats) {
+            ImageNormalizer normalizer;
+            PointOpChain chain(stats.depth());
+            if (percentile)
+                normalizer.append_percentile_normalization(chain, stats, clip, 100.0 - clip);
+            else
+                normalizer.append_normalization(chain, stats);
+            if (gamma != 1.0) chain.append_gamma(gamma);
+            return chain;
+        };
+
+        if (useSampling(currentImg)) {
+            // The preview only has to fill a panel: the sampled chain goes over a
+            // display-sized copy and the full-resolution pass is left to refinement
+            cv::Mat sample = SampledStatistics::sample(currentImg, SampledStatistics::strideFor(currentImg.size(), SAMPLE_TARGET));
+            if (!outputs.isEmpty()) {
+                double scale = std::min(1.0, (double)PREVIEW_MAX_SIDE / std::max(currentImg.cols, currentImg.rows));
+                cv::Mat preview;
+                cv::resize(currentImg, preview, cv::Size(), scale, scale, cv::INTER_AREA);
+                outputs[0]->displayImage(buildChain(sample).apply(preview));
+                markApproximate(outputs[0], true);
+            }
+            approximate = approxNote(sample);
+
+            refineInBackground(currentImg, [this, currentImg, buildChain](const std::atomic<bool>& cancelled) {
+                PointOpChain chain = buildChain(currentImg);
+                if (cancelled) return std::function<void()>();
+                cv::Mat normalized = chain.apply(currentImg);
+                if (cancelled) return std::function<void()>();
+                return std::function<void()>([this, normalized]() {
+                    auto& outputs = mainWindow->getOutputPanels();
+                    if (outputs.isEmpty()) return;
+                    outputs[0]->displayImage(normalized);
+                    markApproximate(outputs[0], false);
+                });
+            });
+        } else if (!outputs.isEmpty()) {
+            outputs[0]->displayImage(buildChain(currentImg).apply(currentImg));
+        }
     }
 
     // ── TASK 6: EQUALIZE ──────────────────────────────────
@@ -138,12 +406,60 @@ void AppController::handleApply() {
 
         ImageEqualizer equalizer;
         cv::Mat result;
+        QString mode = combo->currentText();
+
+        if (mode.startsWith("Match Reference")) {
+            cv::Mat reference = (inputs.size() >= 2) ? inputs[1]->getImage() : cv::Mat();
+            if (reference.empty() || reference.depth() != currentImg.depth()) {
+                mainWindow->setStatusMessage(reference.empty() ? "Need reference image!"
+                                                               : "Reference depth differs!", false);
+                mainWindow->getTopTaskBar()->setProcessing(false);
+                return;
+            }
 
-        if (combo->currentText() == "Grayscale Equalization") {
+            HistogramMatcher matcher;
+            matcher.set_reference(reference);
+            HistogramMatcher::Mode matchMode = (mode == "Match Reference (Per Channel)")
+                ? HistogramMatcher::PER_CHANNEL : HistogramMatcher::LUMA;
+
+            if (mode == "Match Reference · Batch") {
+                QStringList files = QFileDialog::getOpenFileNames(
+                    mainWindow, "Images to Match", QString(), "Images (*.png *.jpg *.jpeg *.bmp *.tif *.tiff)");
+                QString dir = files.isEmpty() ? QString()
+                                              : QFileDialog::getExistingDirectory(mainWindow, "Write Matched Images To");
+                if (dir.isEmpty()) {
+                    mainWindow->getTopTaskBar()->setProcessing(false);
+                    mainWindow->setStatusMessage("Batch cancelled", false);
+                    return;
+                }
+
+                std::vector<std::string> paths;
+                for (const QString& f : files) paths.push_back(f.toStdString());
+                if (!outputs.isEmpty()) outputs[0]->displayImage(matcher.match(currentImg, matchMode));
+
+                std::string directory = dir.toStdString();
+                runBatch("Matching", (int)paths.size(), [matcher, paths, directory, matchMode](std::atomic<int>& done) {
+                    double elapsedMs = 0.0;
+                    int written = matcher.match_files(paths, directory, matchMode, &elapsedMs, &done);
+                    QString msg = QString("Matched %1/%2 · %3 ms").arg(written).arg(paths.size())
+                                      .arg(elapsedMs, 0, 'f', 1);
+                    return BatchResult(msg, written == (int)paths.size());
+                });
+                return;
+            }
+            result = matcher.match(currentImg, matchMode);
+        } else if (mode == "Grayscale Equalization") {
             cv::Mat grayImg;
             if (currentImg.channels() > 1) cv::cvtColor(currentImg, grayImg, cv::COLOR_BGR2GRAY);
             else grayImg = currentImg;
             result = equalizer.equalize_grayScale(grayImg);
+        } else if (mode == "Adaptive (CLAHE)") {
+            if (currentImg.depth() != CV_8U) {
+                mainWindow->setStatusMessage("CLAHE needs 8-bit input!", false);
+                mainWindow->getTopTaskBar()->setProcessing(false);
+                return;
+            }
+            result = equalizer.equalize_clahe(currentImg);
         } else {
             result = (currentImg.channels() == 3)
                 ? equalizer.equalize_rgb(currentImg)
@@ -155,60 +471,137 @@ void AppController::handleApply() {
 
     // ── TASK 7: ENTROPY ───────────────────────────────────
     else if (taskIndex == 7) {
-        double entropy    = EntropyCalculator::calculate(currentImg);
-        cv::Mat histGraph = EntropyCalculator::plotHistogram(currentImg);
-        if (!outputs.isEmpty()) outputs[0]->displayImage(histGraph);
-
-        // Classify entropy level
-        QString levelColor, levelName, levelDesc;
-        if (entropy < 4.5) {
-            levelColor = "#D46B3C";
-            levelName  = "Low";
-            levelDesc  = "Uniform areas dominate — flat sky, solid backgrounds, low structural detail.";
-        } else if (entropy < 6.8) {
-            levelColor = "#5B4FCF";
-            levelName  = "Moderate";
-            levelDesc  = "Typical photograph with natural variance in lighting and subject matter.";
+        QSpinBox* windowSpin = pBox->findChild<QSpinBox*>("entropyWindowSpin");
+        int window = windowSpin ? windowSpin->value() : 9;
+        int maxBits = EntropyCalculator::maxBits(currentImg);
+
+        // Sidebar cards for a global entropy, shown as `valueText` (exact or a
+        // sampled estimate), followed by `extraCards`
+        auto entropyHtml = [maxBits](double entropy, const QString& valueText, const QString& extraCards) {
+            // Classify entropy level; the scale is for 8-bit data, 16-bit values are
+            // compared at the same fraction of their 16-bit maximum
+            double level = entropy * 8.0 / maxBits;
+            QString levelColor, levelName, levelDesc;
+            if (level < 4.5) {
+                levelColor = "#D46B3C";
+                levelName  = "Low";
+                levelDesc  = "Uniform areas dominate — flat sky, solid backgrounds, low structural detail.";
+            } else if (level < 6.8) {
+                levelColor = "#5B4FCF";
+                levelName  = "Moderate";
+                levelDesc  = "Typical photograph with natural variance in lighting and subject matter.";
+            } else {
+                levelColor = "#2D9B6F";
+                levelName  = "High";
+                levelDesc  = "Rich texture, complex detail, or high-frequency noise present.";
+            }
+
+            return QString(R"(
+                <style>
+                    body { font-family: 'DM Sans', 'Segoe UI', sans-serif; color: #2C2825; margin: 0; padding: 0; }
+                    .card { background: #FFFFFF; border: 1px solid #E6E0F7; border-radius: 12px; padding: 14px 16px; margin-bottom: 12px; }
+                    .card h4 { margin: 0 0 6px; font-size: 11px; font-weight: 700; letter-spacing: 0.1em; color: #A09890; text-transform: uppercase; }
+                    .val { font-size: 26px; font-weight: 900; color: %1; letter-spacing: -0.02em; }
+                    .unit { font-size: 13px; font-weight: 700; color: #A09890; }
+                    .badge { display: inline-block; background: %1; color: #FFFFFF; border-radius: 6px; padding: 3px 10px; font-size: 11px; font-weight: 800; margin-bottom: 8px; }
+                    .desc { font-size: 12px; color: #7A7268; line-height: 1.6; }
+                    .formula { font-size: 13px; font-weight: 700; color: #5B4FCF; background: #EDE8FF; border-radius: 6px; padding: 6px 12px; display: inline-block; margin-top: 6px; }
+                    .range-row { display: flex; margin: 4px 0; }
+                    .range-dot { width: 8px; height: 8px; border-radius: 4px; margin: 4px 8px 0 0; flex-shrink: 0; }
+                    .range-txt { font-size: 11px; color: #7A7268; }
+                </style>
+                <div class='card'>
+                    <h4>Shannon Entropy</h4>
+                    <div class='val'>%2</div>
+                    <br>
+                    <span class='badge'>%3</span>
+                    <p class='desc'>%4</p>
+                </div>
+                <div class='card'>
+                    <h4>Reference Scale</h4>
+                    <div class='range-row'><div class='range-dot' style='background:#D46B3C'></div><div class='range-txt'>&lt; 4.5 · Low — uniform images</div></div>
+                    <div class='range-row'><div class='range-dot' style='background:#5B4FCF'></div><div class='range-txt'>4.5–6.8 · Moderate — natural photos</div></div>
+                    <div class='range-row'><div class='range-dot' style='background:#2D9B6F'></div><div class='range-txt'>&gt; 6.8 · High — complex/noisy</div></div>
+                </div>
+                <div class='card'>
+                    <h4>Formula</h4>
+                    <div class='formula'>H = −Σ pᵢ log₂(pᵢ)</div>
+                    <p class='desc' style='margin-top: 8px;'>Computed from a manually built %5-bin histogram without OpenCV's calcHist (max %6 bits).</p>
+                </div>
+            )").arg(levelColor).arg(valueText).arg(levelName).arg(levelDesc)
+               .arg(1 << maxBits).arg(maxBits) + extraCards;
+        };
+
+        // Local entropy map in the second output, for texture segmentation
+        auto localCard = [window](const cv::Mat& localMap) {
+            double localMin = 0.0, localMax = 0.0;
+            cv::minMaxLoc(localMap, &localMin, &localMax);
+            return QString(R"(
+                <div class='card'>
+                    <h4>Local Entropy · %1×%1</h4>
+                    <p class='desc'>min %2 · mean %3 · max %4 bits</p>
+                </div>
+            )").arg(window).arg(localMin, 0, 'f', 2).arg(cv::mean(localMap)[0], 0, 'f', 2).arg(localMax, 0, 'f', 2);
+        };
+
+        if (useSampling(currentImg)) {
+            // Estimate ± two standard errors now; the map needs every pixel, so it
+            // arrives with the exact figures
+            cv::Mat sample = SampledStatistics::sample(currentImg, SampledStatistics::strideFor(currentImg.size(), SAMPLE_TARGET));
+            cv::Mat graySample = sample;
+            if (graySample.channels() == 3) cv::cvtColor(graySample, graySample, cv::COLOR_BGR2GRAY);
+            double stdError = 0.0;
+            double estimate = SampledStatistics::entropy(graySample, &stdError);
+
+            if (!outputs.isEmpty()) {
+                outputs[0]->displayImage(EntropyCalculator::plotHistogram(sample));
+                markApproximate(outputs[0], true);
+            }
+            if (outputs.size() >= 2) outputs[1]->clear();
+            approximate = approxNote(sample);
+
+            QString pending = QString(R"(
+                <div class='card'>
+                    <h4>Local Entropy · %1×%1</h4>
+                    <p class='desc'>Computing the full-resolution map…</p>
+                </div>
+            )").arg(window);
+            mainWindow->getInfoSidebar()->setHtml(entropyHtml(
+                estimate,
+                QString("≈ %1 <span class='unit'>± %2</span>").arg(estimate, 0, 'f', 3).arg(2.0 * stdError, 0, 'f', 3),
+                pending));
+
+            refineInBackground(currentImg, [this, currentImg, window, entropyHtml, localCard](const std::atomic<bool>& cancelled) {
+                double entropy = EntropyCalculator::calculate(currentImg);
+                cv::Mat histGraph = EntropyCalculator::plotHistogram(currentImg);
+                if (cancelled) return std::function<void()>();
+                cv::Mat localMap = EntropyCalculator::localEntropyMap(currentImg, window);
+                if (cancelled) return std::function<void()>();
+                cv::Mat rendered = EntropyCalculator::renderEntropyMap(localMap);
+                QString html = entropyHtml(entropy, QString::number(entropy, 'f', 4), localCard(localMap));
+                return std::function<void()>([this, histGraph, rendered, html]() {
+                    auto& outputs = mainWindow->getOutputPanels();
+                    if (!outputs.isEmpty()) {
+                        outputs[0]->displayImage(histGraph);
+                        markApproximate(outputs[0], false);
+                    }
+                    if (outputs.size() >= 2) outputs[1]->displayImage(rendered);
+                    mainWindow->getInfoSidebar()->setHtml(html);
+                });
+            });
         } else {
-            levelColor = "#2D9B6F";
-            levelName  = "High";
-            levelDesc  = "Rich texture, complex detail, or high-frequency noise present.";
-        }
+            double entropy    = EntropyCalculator::calculate(currentImg);
+            cv::Mat histGraph = EntropyCalculator::plotHistogram(currentImg);
+            if (!outputs.isEmpty()) outputs[0]->displayImage(histGraph);
 
-        QString html = QString(R"(
-            <style>
-                body { font-family: 'DM Sans', 'Segoe UI', sans-serif; color: #2C2825; margin: 0; padding: 0; }
-                .card { background: #FFFFFF; border: 1px solid #E6E0F7; border-radius: 12px; padding: 14px 16px; margin-bottom: 12px; }
-                .card h4 { margin: 0 0 6px; font-size: 11px; font-weight: 700; letter-spacing: 0.1em; color: #A09890; text-transform: uppercase; }
-                .val { font-size: 26px; font-weight: 900; color: %1; letter-spacing: -0.02em; }
-                .badge { display: inline-block; background: %1; color: #FFFFFF; border-radius: 6px; padding: 3px 10px; font-size: 11px; font-weight: 800; margin-bottom: 8px; }
-                .desc { font-size: 12px; color: #7A7268; line-height: 1.6; }
-                .formula { font-size: 13px; font-weight: 700; color: #5B4FCF; background: #EDE8FF; border-radius: 6px; padding: 6px 12px; display: inline-block; margin-top: 6px; }
-                .range-row { display: flex; margin: 4px 0; }
-                .range-dot { width: 8px; height: 8px; border-radius: 4px; margin: 4px 8px 0 0; flex-shrink: 0; }
-                .range-txt { font-size: 11px; color: #7A7268; }
-            </style>
-            <div class='card'>
-                <h4>Shannon Entropy</h4>
-                <div class='val'>%2</div>
-                <br>
-                <span class='badge'>%3</span>
-                <p class='desc'>%4</p>
-            </div>
-            <div class='card'>
-                <h4>Reference Scale</h4>
-                <div class='range-row'><div class='range-dot' style='background:#D46B3C'></div><div class='range-txt'>&lt; 4.5 · Low — uniform images</div></div>
-                <div class='range-row'><div class='range-dot' style='background:#5B4FCF'></div><div class='range-txt'>4.5–6.8 · Moderate — natural photos</div></div>
-                <div class='range-row'><div class='range-dot' style='background:#2D9B6F'></div><div class='range-txt'>&gt; 6.8 · High — complex/noisy</div></div>
-            </div>
-            <div class='card'>
-                <h4>Formula</h4>
-                <div class='formula'>H = −Σ pᵢ log₂(pᵢ)</div>
-                <p class='desc' style='margin-top: 8px;'>Computed from a manually built 256-bin histogram without OpenCV's calcHist.</p>
-            </div>
-        )").arg(levelColor).arg(entropy, 0, 'f', 4).arg(levelName).arg(levelDesc);
+            double elapsedMs = 0.0;
+            cv::Mat localMap = EntropyCalculator::localEntropyMap(currentImg, window, &elapsedMs);
+            if (outputs.size() >= 2) outputs[1]->displayImage(EntropyCalculator::renderEntropyMap(localMap));
+            timing = QString(" · %1 ms").arg(elapsedMs, 0, 'f', 1);
 
-        mainWindow->getInfoSidebar()->setHtml(html);
+            mainWindow->getInfoSidebar()->setHtml(
+                entropyHtml(entropy, QString::number(entropy, 'f', 4), localCard(localMap)));
+        }
     }
 
     // ── TASK 8: COLOR TRANSFORM ───────────────────────────
@@ -231,8 +624,19 @@ void AppController::handleApply() {
 
         FrequencyFilters::FilterType type =
             (combo->currentText() == "Low Pass") ? FrequencyFilters::LOW_PASS : FrequencyFilters::HIGH_PASS;
-        cv::Mat result = FrequencyFilters::applyFilter(currentImg, 50.0f, type);
+        QComboBox* spectrumCombo = pBox->findChild<QComboBox*>("spectrumCombo");
+        bool showSpectrum = !spectrumCombo || spectrumCombo->currentText() == "Show";
+
+        double elapsedMs = 0.0;
+        cv::Mat spectrum;
+        cv::Mat result = FrequencyFilters::applyFilter(currentImg, 50.0f, type, selectedColorMode(),
+                                                       &elapsedMs, showSpectrum ? &spectrum : nullptr);
         if (!outputs.isEmpty()) outputs[0]->displayImage(result);
+        if (outputs.size() >= 2) {
+            if (!spectrum.empty()) outputs[1]->displayImage(spectrum);
+            else outputs[1]->clear();
+        }
+        timing = QString(" · %1 ms").arg(elapsedMs, 0, 'f', 1);
     }
 
     // ── TASK 10: HYBRID IMAGES ────────────────────────────
@@ -240,8 +644,10 @@ void AppController::handleApply() {
         if (inputs.size() >= 2) {
             cv::Mat img2 = inputs[1]->getImage();
             if (!currentImg.empty() && !img2.empty()) {
-                cv::Mat result = HybridImageBuilder::createHybrid(currentImg, img2, 15);
+                double elapsedMs = 0.0;
+                cv::Mat result = HybridImageBuilder::createHybrid(currentImg, img2, 15, selectedColorMode(), &elapsedMs);
                 if (!outputs.isEmpty()) outputs[0]->displayImage(result);
+                timing = QString(" · %1 ms").arg(elapsedMs, 0, 'f', 1);
             } else {
                 mainWindow->setStatusMessage("Need 2 images!", false);
                 mainWindow->getTopTaskBar()->setProcessing(false);
@@ -251,11 +657,181 @@ void AppController::handleApply() {
     }
 
     mainWindow->getTopTaskBar()->setProcessing(false);
-    mainWindow->setStatusMessage("Done ✓", true);
+    if (!approximate.isEmpty())
+        mainWindow->setStatusMessage("Preview" + approximate + timing, true);
+    else
+        mainWindow->setStatusMessage("Done ✓" + timing, true);
+}
+
+void AppController::runBatch(const QString& verb, int total, std::function<BatchResult(std::atomic<int>&)> job,
+                             std::function<void()> then) {
+    batchVerb = verb;
+    batchTotal = total;
+    batchThen = then;
+    batchDone = std::make_shared<std::atomic<int>>(0);
+    std::shared_ptr<std::atomic<int>> done = batchDone;
+    batchWatcher.setFuture(QtConcurrent::run([job, done]() { return job(*done); }));
+    batchPoll.start(100);
+}
+
+bool AppController::useSampling(const cv::Mat& image) const {
+    QComboBox* combo = mainWindow->getTopTaskBar()->getParameterBox()->findChild<QComboBox*>("statsModeCombo");
+    if (combo && combo->currentText() == "Exact") return false;
+    return (double)image.total() >= SAMPLING_MIN_PIXELS;
+}
+
+void AppController::refineInBackground(const cv::Mat& source, RefineJob job) {
+    cancelRefinement();
+    pendingRefine = job;
+    pendingSource = source;
+    if (!refineWatcher.isRunning()) startPendingRefine();
+}
+
+void AppController::startPendingRefine() {
+    if (!pendingRefine) return;
+    RefineJob job = pendingRefine;
+    refineSource = pendingSource;
+    pendingRefine = nullptr;
+    pendingSource.release();
+
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    refineCancel = cancel;
+    refineWatcher.setFuture(QtConcurrent::run([job, cancel]() {
+        int64 start = cv::getTickCount();
+        std::function<void()> apply = job(*cancel);
+        return RefineResult(apply, (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency());
+    }));
+}
+
+void AppController::cancelRefinement() {
+    if (refineCancel) *refineCancel = true;
+    pendingRefine = nullptr;
+    pendingSource.release();
+}
+
+void AppController::markApproximate(ImagePanel* panel, bool approximate) {
+    QString title = panel->getTitle();
+    if (title.endsWith(APPROX_SUFFIX)) title.chop(QString(APPROX_SUFFIX).size());
+    panel->setTitle(approximate ? title + APPROX_SUFFIX : title);
+}
+
+void AppController::showQualityMetrics(const cv::Mat& result, const cv::Mat& reference) {
+    auto& inputs = mainWindow->getInputPanels();
+    QTextBrowser* sidebar = mainWindow->getInfoSidebar();
+    if (result.empty() || inputs.isEmpty()) { sidebar->hide(); return; }
+
+    QString cards;
+    auto addCard = [&cards](const QString& title, const cv::Mat& a, const cv::Mat& b) {
+        if (a.empty() || b.empty() || a.size() != b.size()) return;
+        QualityMetrics::Result m = QualityMetrics::compare(a, b);
+        QString psnr = std::isinf(m.psnr) ? QString("∞") : QString::number(m.psnr, 'f', 2);
+        cards += QString(R"(
+            <div class='card'>
+                <h4>%1</h4>
+                <div class='val'>%2 <span class='unit'>dB</span></div>
+                <p class='desc'>SSIM <b>%3</b> · MSE <b>%4</b></p>
+                <p class='time'>%5 ms</p>
+            </div>
+        )").arg(title).arg(psnr).arg(m.ssim, 0, 'f', 4).arg(m.mse, 0, 'f', 2).arg(m.elapsedMs, 0, 'f', 1);
+    };
+
+    cv::Mat source = inputs[0]->getImage();
+    addCard("Output vs Reference", reference, result);
+    addCard("Source vs Reference", reference, source);
+    addCard("Output vs Source", source, result);
+    if (cards.isEmpty()) { sidebar->hide(); return; }
+
+    sidebar->setHtml(R"(
+        <style>
+            body { font-family: 'DM Sans', 'Segoe UI', sans-serif; color: #2C2825; margin: 0; padding: 0; }
+            .card { background: #FFFFFF; border: 1px solid #E6E0F7; border-radius: 12px; padding: 14px 16px; margin-bottom: 12px; }
+            .card h4 { margin: 0 0 6px; font-size: 11px; font-weight: 700; letter-spacing: 0.1em; color: #A09890; text-transform: uppercase; }
+            .val { font-size: 26px; font-weight: 900; color: #5B4FCF; letter-spacing: -0.02em; }
+            .unit { font-size: 13px; font-weight: 700; color: #A09890; }
+            .desc { font-size: 12px; color: #7A7268; line-height: 1.6; margin: 6px 0 0; }
+            .time { font-size: 10px; color: #B8B0A6; font-style: italic; margin: 4px 0 0; }
+        </style>
+    )" + cards);
+    sidebar->show();
+}
+
+void AppController::handleRegionSelected(const cv::Rect& region) {
+    int taskIndex = mainWindow->getTopTaskBar()->getSelectedOperation();
+    if (taskIndex != 4 && taskIndex != 7) return;
+    auto& inputs  = mainWindow->getInputPanels();
+    auto& outputs = mainWindow->getOutputPanels();
+    if (inputs.isEmpty() || inputs[0]->getImage().empty()) return;
+    cancelRefinement();
+    for (auto* panel : outputs) markApproximate(panel, false);
+
+    // Every move is O(bins) once the background index is there
+    if (!regionIndex || inputs[0]->getImage().data != indexedData) {
+        prepareRegionIndex();
+        mainWindow->setStatusMessage("Indexing region statistics…", true);
+        return;
+    }
+
+    int64 start = cv::getTickCount();
+    IntegralHistogram::Stats stats = regionIndex->query(region);
+    double queryUs = (cv::getTickCount() - start) * 1e6 / cv::getTickFrequency();
+
+    cv::Mat hist, cdf;
+    IntegralHistogram::toPlot(stats, hist, cdf);
+    cv::Scalar color = (taskIndex == 4) ? cv::Scalar(155, 140, 230) : cv::Scalar(255, 50, 200);
+    if (!outputs.isEmpty()) outputs[0]->displayImage(HistogramTools::plotHistogram(hist, cdf, color));
+
+    QTextBrowser* sidebar = mainWindow->getInfoSidebar();
+    sidebar->setHtml(QString(R"(
+        <style>
+            body { font-family: 'DM Sans', 'Segoe UI', sans-serif; color: #2C2825; margin: 0; padding: 0; }
+            .card { background: #FFFFFF; border: 1px solid #E6E0F7; border-radius: 12px; padding: 14px 16px; margin-bottom: 12px; }
+            .card h4 { margin: 0 0 6px; font-size: 11px; font-weight: 700; letter-spacing: 0.1em; color: #A09890; text-transform: uppercase; }
+            .val { font-size: 26px; font-weight: 900; color: #5B4FCF; letter-spacing: -0.02em; }
+            .unit { font-size: 13px; font-weight: 700; color: #A09890; }
+            .desc { font-size: 12px; color: #7A7268; line-height: 1.6; margin: 6px 0 0; }
+            .time { font-size: 10px; color: #B8B0A6; font-style: italic; margin: 4px 0 0; }
+        </style>
+        <div class='card'>
+            <h4>Region %1 × %2 at (%3, %4)</h4>
+            <div class='val'>%5 <span class='unit'>bits</span></div>
+            <p class='desc'>Entropy over %6 bins · mean <b>%7</b> · %8 px</p>
+            <p class='time'>%9 µs per query</p>
+        </div>
+    )").arg(stats.region.width).arg(stats.region.height).arg(stats.region.x).arg(stats.region.y)
+       .arg(stats.entropy, 0, 'f', 3).arg(regionIndex->bins()).arg(stats.mean, 0, 'f', 1)
+       .arg((qulonglong)stats.count).arg(queryUs, 0, 'f', 1));
+    sidebar->show();
+}
+
+void AppController::prepareRegionIndex() {
+    int taskIndex = mainWindow->getTopTaskBar()->getSelectedOperation();
+    auto& inputs = mainWindow->getInputPanels();
+    if (taskIndex != 4 && taskIndex != 7) return;
+    if (inputs.isEmpty() || inputs[0]->getImage().empty()) return;
+
+    cv::Mat image = inputs[0]->getImage();
+    if (image.data == indexedData && (regionIndex || indexWatcher.isRunning())) return;
+
+    // A new source: drop the old index now rather than holding both in memory
+    indexedData = image.data;
+    regionIndex.reset();
+    if (indexWatcher.isRunning()) return; // restarted from the finished handler
+
+    indexJobData = image.data;
+    indexWatcher.setFuture(QtConcurrent::run([image]() {
+        int64 start = cv::getTickCount();
+        auto index = std::make_shared<IntegralHistogram>();
+        index->build(image);
+        return IndexResult(index, (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency());
+    }));
 }
 
 void AppController::handleClear() {
-    for (auto* panel : mainWindow->getOutputPanels()) panel->clear();
+    cancelRefinement();
+    for (auto* panel : mainWindow->getOutputPanels()) {
+        panel->clear();
+        markApproximate(panel, false);
+    }
     mainWindow->setStatusMessage("Cleared", true);
 }
 
@@ -265,8 +841,13 @@ void AppController::handleSave() {
         mainWindow->setStatusMessage("Nothing to save", false);
         return;
     }
+    // Sampled previews can be downscaled; only the exact result is saved
+    if (outputs[0]->getTitle().endsWith(APPROX_SUFFIX)) {
+        mainWindow->setStatusMessage("Preview only · wait for the exact result", false);
+        return;
+    }
 
-    QString filter = "PNG Image (*.png);;JPEG Image (*.jpg *.jpeg);;BMP Image (*.bmp)";
+    QString filter = "PNG Image (*.png);;TIFF Image (*.tif *.tiff);;JPEG Image (*.jpg *.jpeg);;BMP Image (*.bmp)";
     QString selectedFilter;
     QString fileName = QFileDialog::getSaveFileName(
         mainWindow, "Save Processed Image", "", filter, &selectedFilter
@@ -278,13 +859,21 @@ void AppController::handleSave() {
                 fileName += ".jpg";
             } else if (selectedFilter.contains("*.bmp")) {
                 fileName += ".bmp";
+            } else if (selectedFilter.contains("*.tif")) {
+                fileName += ".tif";
             } else {
                 fileName += ".png";
             }
         }
 
+        // PNG and TIFF keep 16-bit data, JPEG and BMP only take 8 bits
+        cv::Mat image = outputs[0]->getImage();
+        QString suffix = QFileInfo(fileName).suffix().toLower();
+        if (image.depth() == CV_16U && suffix != "png" && suffix != "tif" && suffix != "tiff")
+            image.convertTo(image, CV_8U, 1.0 / 257.0);
+
         try {
-            bool ok = cv::imwrite(fileName.toStdString(), outputs[0]->getImage());
+            bool ok = cv::imwrite(fileName.toStdString(), image);
             if (ok) {
                 mainWindow->setStatusMessage("Saved ✓", true);
             } else {
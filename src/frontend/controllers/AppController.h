@@ -2,23 +2,86 @@
 #define APPCONTROLLER_H
 
 #include <QObject>
+#include <QFutureWatcher>
+#include <QTimer>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <utility>
 #include "../MainWindow.h"
 #include "ImageStateManager.h"
+#include "../../backend/Module3_HistogramsAndColor/IntegralHistogram.h"
 
 class AppController : public QObject {
     Q_OBJECT
 public:
     AppController(MainWindow* window, QObject *parent = nullptr);
+    ~AppController() override;
 
 private slots:
     void handleTaskChange(int taskIndex);
     void handleApply();
     void handleSave();
     void handleClear();
+    void handleRegionSelected(const cv::Rect& region);
+    void prepareRegionIndex();
 
 private:
+    // Fills the info sidebar with PSNR / SSIM / MSE cards for a filter result,
+    // against the source and, when not empty, a clean reference image
+    void showQualityMetrics(const cv::Mat& result, const cv::Mat& reference);
+
+    // File batches (Tasks 1 and 6) and the Task 2 autotune sweep run on the
+    // thread pool with Apply held in "Working...". `job` counts finished items in
+    // its argument, which the status chip polls against `total`, and returns the
+    // final status and success flag; `then`, if set, runs on the GUI thread after.
+    typedef std::pair<QString, bool> BatchResult;
+    void runBatch(const QString& verb, int total, std::function<BatchResult(std::atomic<int>&)> job,
+                  std::function<void()> then = nullptr);
+
+    // Progressive statistics (Tasks 4, 5 and 7): true when the image is large
+    // enough and the parameter box is not set to "Exact"
+    bool useSampling(const cv::Mat& image) const;
+    // Runs `job` on the controller's refinement worker; the function it returns
+    // is applied on the GUI thread unless the preview was superseded or `source`
+    // replaced meanwhile. One job runs at a time: a newer one cancels the running
+    // job and takes its place. Jobs poll the flag between stages and return an
+    // empty function once it is set.
+    typedef std::function<std::function<void()>(const std::atomic<bool>& cancelled)> RefineJob;
+    void refineInBackground(const cv::Mat& source, RefineJob job);
+    void startPendingRefine();
+    // Drops the queued refinement and cancels the running one
+    void cancelRefinement();
+    // Adds or removes the "≈ approx" badge on an output panel title
+    static void markApproximate(ImagePanel* panel, bool approximate);
+
     MainWindow* mainWindow;
     ImageStateManager stateManager;
+
+    QFutureWatcher<BatchResult> batchWatcher;
+    QTimer batchPoll;
+    std::shared_ptr<std::atomic<int>> batchDone;
+    QString batchVerb;
+    int batchTotal = 0;
+    std::function<void()> batchThen;
+
+    // Region statistics for Tasks 4 and 7, indexed in the background once per
+    // source image (on load or when the task is picked). indexedData identifies
+    // the image without keeping it alive; drags before the index is ready only
+    // report progress.
+    typedef std::pair<std::shared_ptr<IntegralHistogram>, double> IndexResult;
+    std::shared_ptr<IntegralHistogram> regionIndex;
+    QFutureWatcher<IndexResult> indexWatcher;
+    const uchar* indexedData = nullptr;
+    const uchar* indexJobData = nullptr;
+
+    // Exact results behind a sampled preview (Tasks 4, 5 and 7)
+    typedef std::pair<std::function<void()>, double> RefineResult;
+    QFutureWatcher<RefineResult> refineWatcher;
+    std::shared_ptr<std::atomic<bool>> refineCancel;
+    cv::Mat refineSource;
+    RefineJob pendingRefine;
+    cv::Mat pendingSource;
 };
 
 #endif // APPCONTROLLER_H
@@ -1,6 +1,11 @@
 #include <QApplication>
 #include <QFontDatabase>
+#include <QDir>
+#include <QStandardPaths>
 #include "frontend/MainWindow.h"
+#include <QtConcurrent/QtConcurrent>
+#include "backend/core/FFTBackend.h"
+#include "backend/core/Convolution.h"
 
 int main(int argc, char *argv[]) {
     QApplication app(argc, argv);
@@ -498,11 +503,24 @@ int main(int argc, char *argv[]) {
 
     app.setStyleSheet(styleSheet);
 
+    // Where FFTW (when built in) keeps its plans between sessions; the default
+    // cv::dft backend has nothing to keep and writes no file
+    QString wisdomDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    if (!wisdomDir.isEmpty() && QDir().mkpath(wisdomDir))
+        FFTBackend::setWisdomDirectory(wisdomDir.toStdString());
+
+    // Measure the convolution tile cap and FFT/direct crossover off the GUI
+    // thread; Disk Blur uses the defaults until it finishes
+    QFuture<void> calibration = QtConcurrent::run([]() { Convolution::calibrate(); });
+
     MainWindow window;
     window.setWindowTitle("Vision Studio — Advanced Image Processing");
     window.resize(1440, 900);
     window.setMinimumSize(1100, 700);
     window.show();
 
-    return app.exec();
+    int exitCode = app.exec();
+    calibration.waitForFinished();
+    FFTBackend::active().flushWisdom();
+    return exitCode;
 }
\ No newline at end of file